@@ -0,0 +1,115 @@
+#include<cstdint>
+#include<memory_resource>
+#include<vector>
+
+#include<core/memory/page_allocator.hpp>
+#include<core/memory/pool_allocator.hpp>
+#include<core/memory/linear_arena.hpp>
+#include<core/memory/allocator_handle.hpp>
+#include<core/memory/static_allocator_ref.hpp>
+#include<core/memory/memory_resource.hpp>
+
+#include<benchmark/benchmark.h>
+
+using namespace engine::mem::allocator;
+
+constexpr std::size_t kObjects = 4096;
+
+struct Particle{
+	float pos[3];
+	float vel[3];
+	float life;
+	std::uint32_t id;
+};
+
+// each benchmark fills the pool and drains it again, so the time per
+// object is one alloc_new plus one free_delete
+template<typename Handle>
+static void churn(benchmark::State& state, Handle& handle){
+	std::vector<Particle*> live(kObjects);
+	for(auto _ : state){
+		for(std::size_t i = 0; i < kObjects; ++i){
+			live[i] = alloc_new<Particle>(handle,
+				Particle{{0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}, 1.f, static_cast<std::uint32_t>(i)});
+		}
+		benchmark::DoNotOptimize(live);
+		for(std::size_t i = 0; i < kObjects; ++i){
+			free_delete(handle, live[i]);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kObjects));
+}
+
+static void BM_handle(benchmark::State& state){
+	PageAllocator pages;
+	pages.init(1024 * 1024);
+	PoolAllocator pool(pages, sizeof(Particle), kObjects, 16);
+	auto handle = AllocatorHandle::from_pool(pool);
+	churn(state, handle);
+}
+BENCHMARK(BM_handle);
+
+static void BM_static_ref(benchmark::State& state){
+	PageAllocator pages;
+	pages.init(1024 * 1024);
+	PoolAllocator pool(pages, sizeof(Particle), kObjects, 16);
+	StaticAllocatorRef ref(pool);
+	churn(state, ref);
+}
+BENCHMARK(BM_static_ref);
+
+static void BM_pmr_new_object(benchmark::State& state){
+	PageAllocator pages;
+	pages.init(1024 * 1024);
+	PoolAllocator pool(pages, sizeof(Particle), kObjects, 16);
+	HandleMemoryResource resource(StaticAllocatorRef{pool});
+	std::pmr::polymorphic_allocator<Particle> alloc(&resource);
+
+	std::vector<Particle*> live(kObjects);
+	for(auto _ : state){
+		for(std::size_t i = 0; i < kObjects; ++i){
+			live[i] = alloc.new_object<Particle>(
+				Particle{{0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}, 1.f, static_cast<std::uint32_t>(i)});
+		}
+		benchmark::DoNotOptimize(live);
+		for(std::size_t i = 0; i < kObjects; ++i){
+			alloc.delete_object(live[i]);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kObjects));
+}
+BENCHMARK(BM_pmr_new_object);
+
+// growth of a pmr vector over an arena, the container path for
+// systems moved onto engine allocators
+static void BM_pmr_vector(benchmark::State& state){
+	PageAllocator pages;
+	pages.init(4 * 1024 * 1024);
+	LinearArena arena(pages, 2 * 1024 * 1024);
+	HandleMemoryResource resource(StaticAllocatorRef{arena});
+
+	for(auto _ : state){
+		{
+			std::pmr::vector<Particle> particles(&resource);
+			for(std::size_t i = 0; i < kObjects; ++i){
+				particles.push_back(
+					Particle{{0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}, 1.f, static_cast<std::uint32_t>(i)});
+			}
+			benchmark::DoNotOptimize(particles.data());
+		}
+		arena.reset();
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kObjects));
+}
+BENCHMARK(BM_pmr_vector);
+
+int main(int argc, char**argv){
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
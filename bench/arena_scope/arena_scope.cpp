@@ -0,0 +1,75 @@
+#include<cstdint>
+#include<cstring>
+
+#include<core/memory/page_allocator.hpp>
+#include<core/memory/linear_arena.hpp>
+#include<core/memory/arena_scope.hpp>
+
+#include<benchmark/benchmark.h>
+
+using namespace engine::mem::allocator;
+
+// one frame of nested temporary work: a few passes (culling, sorting,
+// string building), each with its own scratch and a couple of sub steps
+constexpr std::size_t kPasses = 16;
+constexpr std::size_t kSubSteps = 4;
+constexpr std::size_t kPassScratch = 64 * 1024;
+constexpr std::size_t kStepScratch = 16 * 1024;
+constexpr std::size_t kArenaBytes = 8 * 1024 * 1024;
+
+template<bool Scoped>
+static void run_step(LinearArena& arena){
+	if constexpr(Scoped){
+		ArenaScope scope(arena);
+		auto* p = static_cast<std::byte*>(scope.allocate(kStepScratch, 64));
+		std::memset(p, 1, kStepScratch);
+		benchmark::DoNotOptimize(p);
+	}
+	else{
+		auto* p = static_cast<std::byte*>(arena.allocate(kStepScratch, 64));
+		std::memset(p, 1, kStepScratch);
+		benchmark::DoNotOptimize(p);
+	}
+}
+
+template<bool Scoped>
+static void run_pass(LinearArena& arena){
+	if constexpr(Scoped){
+		ArenaScope scope(arena);
+		auto* p = static_cast<std::byte*>(scope.allocate(kPassScratch, 64));
+		std::memset(p, 0, kPassScratch);
+		for(std::size_t s = 0; s < kSubSteps; ++s) run_step<true>(arena);
+		benchmark::DoNotOptimize(p);
+	}
+	else{
+		auto* p = static_cast<std::byte*>(arena.allocate(kPassScratch, 64));
+		std::memset(p, 0, kPassScratch);
+		for(std::size_t s = 0; s < kSubSteps; ++s) run_step<false>(arena);
+		benchmark::DoNotOptimize(p);
+	}
+}
+
+template<bool Scoped>
+static void BM_nested_frame(benchmark::State& state){
+	PageAllocator pages;
+	pages.init(kArenaBytes);
+	LinearArena arena(pages, kArenaBytes);
+
+	for(auto _ : state){
+		for(std::size_t pass = 0; pass < kPasses; ++pass) run_pass<Scoped>(arena);
+		arena.reset();
+	}
+
+	state.counters["peak_kb"] = static_cast<double>(arena.stats().peak) / 1024.0;
+}
+BENCHMARK_TEMPLATE(BM_nested_frame, false)->Name("BM_reset_only")->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_nested_frame, true)->Name("BM_scoped")->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char**argv){
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,109 @@
+#include<cstdint>
+#include<cstring>
+
+#include<core/memory/page_allocator.hpp>
+#include<core/memory/page_worker.hpp>
+
+#include<benchmark/benchmark.h>
+
+#if defined(__linux__)
+	#include<sys/resource.h>
+#endif
+
+using namespace engine::mem::allocator;
+using engine::mem::os::PrefaultMode;
+
+// every frame takes fresh memory and writes it, the whole run fits in
+//	the commit-ahead window that loading sets up
+constexpr std::size_t kFrameBytes = 512 * 1024;
+constexpr std::int64_t kFrames = 128;
+constexpr std::size_t kWindowBytes = kFrameBytes * kFrames + 1024 * 1024;
+constexpr std::size_t kReserveBytes = std::size_t{256} * 1024 * 1024;
+
+PageAllocator g_pages;
+PageWorker* g_worker = nullptr;
+
+static std::int64_t minor_faults(){
+#if defined(__linux__)
+	rusage usage{};
+	getrusage(RUSAGE_THREAD, &usage);
+	return usage.ru_minflt;
+#else
+	return 0;
+#endif
+}
+
+static void setup(std::size_t ahead, PrefaultMode prefault, bool worker){
+	g_worker = worker ? new PageWorker() : nullptr;
+
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = kReserveBytes;
+	desc.commit_ahead_bytes = ahead;
+	desc.prefault = prefault;
+	desc.worker = g_worker;
+	g_pages.init(desc);
+
+	// loading: the first commit opens the window
+	benchmark::DoNotOptimize(g_pages.allocate(64, 64));
+	if(g_worker) g_worker->flush();
+}
+
+static void setup_on_demand(const benchmark::State&){
+	setup(0, PrefaultMode::None, false);
+}
+static void setup_ahead(const benchmark::State&){
+	setup(kWindowBytes, PrefaultMode::None, false);
+}
+static void setup_ahead_touch(const benchmark::State&){
+	setup(kWindowBytes, PrefaultMode::Touch, false);
+}
+static void setup_ahead_populate(const benchmark::State&){
+	setup(kWindowBytes, PrefaultMode::Populate, false);
+}
+static void setup_ahead_worker(const benchmark::State&){
+	setup(kWindowBytes, PrefaultMode::Populate, true);
+}
+
+static void teardown(const benchmark::State&){
+	g_pages.shutdown();
+	delete g_worker;
+	g_worker = nullptr;
+}
+
+static void BM_frame(benchmark::State& state){
+	std::int64_t faults = 0;
+	for(auto _ : state){
+		const std::int64_t before = minor_faults();
+		void* p = g_pages.allocate(kFrameBytes, 64);
+		if(!p){
+			state.SkipWithError("allocation failed");
+			return;
+		}
+		std::memset(p, 1, kFrameBytes);
+		benchmark::ClobberMemory();
+		faults += minor_faults() - before;
+	}
+	state.counters["minflt/frame"] = benchmark::Counter(
+		static_cast<double>(faults), benchmark::Counter::kAvgIterations);
+	state.counters["committed_MiB"] = static_cast<double>(
+		g_pages.committed_bytes()) / (1024.0 * 1024.0);
+}
+
+#define FRAME_BENCH(name, setup_fn) \
+	BENCHMARK(BM_frame)->Name(name)->Setup(setup_fn)->Teardown(teardown) \
+		->Iterations(kFrames)->Unit(benchmark::kMicrosecond)
+
+FRAME_BENCH("BM_frame_commit_on_demand", setup_on_demand);
+FRAME_BENCH("BM_frame_commit_ahead", setup_ahead);
+FRAME_BENCH("BM_frame_commit_ahead_touch", setup_ahead_touch);
+FRAME_BENCH("BM_frame_commit_ahead_populate", setup_ahead_populate);
+FRAME_BENCH("BM_frame_commit_ahead_worker", setup_ahead_worker);
+
+int main(int argc, char**argv){
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include<cstdint>
+#include<unordered_map>
+#include<vector>
+
+#include<core/containers/hash_map.hpp>
+#include<core/memory/default_heap.hpp>
+#include<core/memory/allocator_handle.hpp>
+
+#include<benchmark/benchmark.h>
+
+using namespace engine::containers;
+using namespace engine::mem::allocator;
+
+using Key = std::uint64_t;
+using Value = std::uint64_t;
+
+static std::vector<Key> make_keys(std::size_t n, std::uint64_t seed){
+	std::vector<Key> keys(n);
+	for(auto& k : keys){
+		// splitmix64
+		seed += 0x9E3779B97F4A7C15ull;
+		std::uint64_t z = seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		k = z ^ (z >> 31);
+	}
+	return keys;
+}
+
+// same calls on both maps, HashMap reports failure instead of throwing
+struct EngineMap{
+	DefaultHeap heap;
+	HashMap<Key, Value> map{AllocatorHandle::from_heap(heap)};
+
+	void insert(Key k, Value v){ map.try_emplace(k, v); }
+	bool find(Key k) const { return map.find(k) != nullptr; }
+	void erase(Key k){ map.erase(k); }
+};
+
+struct StdMap{
+	std::unordered_map<Key, Value> map;
+
+	void insert(Key k, Value v){ map.try_emplace(k, v); }
+	bool find(Key k) const { return map.find(k) != map.end(); }
+	void erase(Key k){ map.erase(k); }
+};
+
+template<typename Map>
+static void BM_insert(benchmark::State& state){
+	const auto keys = make_keys(static_cast<std::size_t>(state.range(0)), 1);
+	for(auto _ : state){
+		Map m;
+		for(Key k : keys) m.insert(k, k);
+		benchmark::DoNotOptimize(m);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename Map>
+static void lookup(benchmark::State& state, std::uint64_t probe_seed){
+	const auto keys = make_keys(static_cast<std::size_t>(state.range(0)), 1);
+	const auto probes = make_keys(static_cast<std::size_t>(state.range(0)), probe_seed);
+	Map m;
+	for(Key k : keys) m.insert(k, k);
+
+	for(auto _ : state){
+		std::size_t hits = 0;
+		for(Key k : probes) hits += m.find(k);
+		benchmark::DoNotOptimize(hits);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename Map>
+static void BM_lookup_hit(benchmark::State& state){ lookup<Map>(state, 1); }
+
+template<typename Map>
+static void BM_lookup_miss(benchmark::State& state){ lookup<Map>(state, 2); }
+
+template<typename Map>
+static void BM_erase(benchmark::State& state){
+	const auto keys = make_keys(static_cast<std::size_t>(state.range(0)), 1);
+	for(auto _ : state){
+		state.PauseTiming();
+		auto* m = new Map();
+		for(Key k : keys) m->insert(k, k);
+		state.ResumeTiming();
+
+		for(Key k : keys) m->erase(k);
+		benchmark::DoNotOptimize(m);
+
+		state.PauseTiming();
+		delete m;
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define MAP_BENCH(fn) \
+	BENCHMARK_TEMPLATE(fn, EngineMap)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond); \
+	BENCHMARK_TEMPLATE(fn, StdMap)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond)
+
+MAP_BENCH(BM_insert);
+MAP_BENCH(BM_lookup_hit);
+MAP_BENCH(BM_lookup_miss);
+MAP_BENCH(BM_erase);
+
+int main(int argc, char**argv){
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
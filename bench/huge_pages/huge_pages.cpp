@@ -0,0 +1,92 @@
+#include<iostream>
+#include<cstdint>
+
+#include<core/memory/page_allocator.hpp>
+
+#include<benchmark/benchmark.h>
+
+using namespace engine::mem::allocator;
+using engine::mem::os::PageBacking;
+
+// 512 MiB of u64, far beyond what the dTLB covers with 4 KiB pages
+constexpr std::size_t kBytes = std::size_t{512} * 1024 * 1024;
+constexpr std::size_t kCount = kBytes / sizeof(std::uint64_t);
+constexpr std::size_t kAccessesPerIteration = 1 << 20;
+
+PageAllocator g_pages;
+std::uint64_t* g_data = nullptr;
+
+static const char* backing_name(PageBacking b){
+	switch(b){
+		case PageBacking::Regular: return "regular";
+		case PageBacking::TransparentHuge: return "transparent_huge";
+		case PageBacking::ExplicitHuge: return "explicit_huge";
+	}
+	return "unknown";
+}
+
+static void setup_pages(bool huge){
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = kBytes;
+	desc.huge_pages = huge;
+	g_pages.init(desc);
+
+	g_data = static_cast<std::uint64_t*>(g_pages.allocate(kBytes, 64));
+	for(std::size_t i = 0; i < kCount; ++i) g_data[i] = i;
+}
+
+static void setup_regular(const benchmark::State&){ setup_pages(false); }
+static void setup_huge(const benchmark::State&){ setup_pages(true); }
+
+static void teardown(const benchmark::State&){
+	g_data = nullptr;
+	g_pages.shutdown();
+}
+
+static void BM_random_access(benchmark::State& state){
+	if(!g_data){
+		state.SkipWithError("allocation failed");
+		return;
+	}
+	state.SetLabel(backing_name(g_pages.page_backing()));
+
+	std::uint64_t x = 0x9E3779B97F4A7C15ull;
+	std::uint64_t sum = 0;
+	for(auto _ : state){
+		for(std::size_t i = 0; i < kAccessesPerIteration; ++i){
+			x ^= x << 13;
+			x ^= x >> 7;
+			x ^= x << 17;
+			sum += g_data[x & (kCount - 1)];
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(
+		state.iterations() * kAccessesPerIteration));
+}
+
+BENCHMARK(BM_random_access)
+	->Name("BM_random_access_regular_pages")
+	->Setup(setup_regular)
+	->Teardown(teardown)
+	->Repetitions(5)
+	->DisplayAggregatesOnly(true);
+
+BENCHMARK(BM_random_access)
+	->Name("BM_random_access_huge_pages")
+	->Setup(setup_huge)
+	->Teardown(teardown)
+	->Repetitions(5)
+	->DisplayAggregatesOnly(true);
+
+int main(int argc, char**argv){
+	std::cout << "huge page size: "
+		<< engine::mem::os::VirtualMemory::get_huge_page_size() << std::endl;
+
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
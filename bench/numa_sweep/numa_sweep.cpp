@@ -0,0 +1,114 @@
+#include<cstdint>
+#include<cstring>
+#include<string>
+
+#include<core/memory/page_allocator.hpp>
+#include<core/memory/linear_arena.hpp>
+
+#include<benchmark/benchmark.h>
+
+#if defined(__linux__)
+	#include<sched.h>
+#endif
+
+using namespace engine::mem::allocator;
+using engine::mem::os::NumaPolicy;
+using engine::mem::os::VirtualMemory;
+
+// 512 MiB sweep, well past the last level cache of either socket
+constexpr std::size_t kBytes = std::size_t{512} * 1024 * 1024;
+constexpr std::size_t kCount = kBytes / sizeof(std::uint64_t);
+
+PageAllocator g_pages;
+LinearArena* g_arena = nullptr;
+std::uint64_t* g_data = nullptr;
+
+// keep the thread on one cpu so local stays local for the whole run
+static void pin_to_current_cpu(){
+#if defined(__linux__)
+	const int cpu = sched_getcpu();
+	if(cpu < 0) return;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	sched_setaffinity(0, sizeof(set), &set);
+#endif
+}
+
+static void setup(NumaPolicy policy, int node){
+	pin_to_current_cpu();
+
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = kBytes + 1024 * 1024;
+	desc.numa_policy = policy;
+	desc.numa_node = node;
+	g_pages.init(desc);
+
+	g_arena = new LinearArena(g_pages, kBytes);
+	g_data = static_cast<std::uint64_t*>(g_arena->allocate(kBytes, 64));
+	if(g_data) std::memset(g_data, 1, kBytes);
+}
+
+static void setup_local(const benchmark::State&){
+	setup(NumaPolicy::Local, 0);
+}
+
+static void setup_remote(const benchmark::State&){
+	const int nodes = VirtualMemory::numa_node_count();
+	setup(NumaPolicy::Node, (VirtualMemory::current_numa_node() + 1) % nodes);
+}
+
+static void teardown(const benchmark::State&){
+	delete g_arena;
+	g_arena = nullptr;
+	g_data = nullptr;
+	g_pages.shutdown();
+}
+
+static void BM_sweep(benchmark::State& state){
+	if(!g_data){
+		state.SkipWithError("allocation failed");
+		return;
+	}
+	const int nodes = VirtualMemory::numa_node_count();
+	if(state.range(0) && nodes < 2){
+		state.SkipWithError("single NUMA node, nothing is remote");
+		return;
+	}
+	state.SetLabel(std::to_string(nodes) + " nodes, thread on node "
+		+ std::to_string(VirtualMemory::current_numa_node()));
+
+	for(auto _ : state){
+		std::uint64_t sum = 0;
+		for(std::size_t i = 0; i < kCount; ++i) sum += g_data[i];
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kBytes));
+}
+
+BENCHMARK(BM_sweep)
+	->Name("BM_sweep_local_node")
+	->Arg(0)
+	->Setup(setup_local)
+	->Teardown(teardown)
+	->Unit(benchmark::kMillisecond)
+	->Repetitions(5)
+	->DisplayAggregatesOnly(true);
+
+BENCHMARK(BM_sweep)
+	->Name("BM_sweep_remote_node")
+	->Arg(1)
+	->Setup(setup_remote)
+	->Teardown(teardown)
+	->Unit(benchmark::kMillisecond)
+	->Repetitions(5)
+	->DisplayAggregatesOnly(true);
+
+int main(int argc, char**argv){
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,76 @@
+#include<iostream>
+#include<thread>
+
+#include<core/memory/page_allocator.hpp>
+
+#include<benchmark/benchmark.h>
+
+using namespace engine::mem::allocator;
+
+// every thread carves kIterations blocks, the allocator is recreated
+// for each run so the reserved range never runs out
+// the mutex path rounds each block up to a page, both paths commit
+// kCommitAhead at a time so the comparison is the locking, not mprotect,
+// 32 threads of 4 KiB pages need 2 GiB of range
+constexpr std::size_t kBlockSize = 64;
+constexpr std::size_t kIterations = 1 << 14;
+constexpr std::size_t kMaxThreads = 32;
+constexpr std::size_t kCommitAhead = 16 * 1024 * 1024;
+constexpr std::size_t kReserve = kMaxThreads * kIterations * 4096 + kCommitAhead;
+
+PageAllocator g_pages;
+
+static void init_mutex(const benchmark::State&){
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = kReserve;
+	desc.commit_ahead_bytes = kCommitAhead;
+	g_pages.init(desc);
+}
+
+static void init_thread_chunks(const benchmark::State&){
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = kReserve;
+	desc.commit_ahead_bytes = kCommitAhead;
+	desc.thread_chunk_bytes = 256 * 1024;
+	g_pages.init(desc);
+}
+
+static void shutdown_pages(const benchmark::State&){
+	g_pages.shutdown();
+}
+
+static void BM_page_alloc(benchmark::State& state){
+	for(auto _ : state){
+		void* p = g_pages.allocate(kBlockSize, 16);
+		benchmark::DoNotOptimize(p);
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_page_alloc)
+	->Name("BM_page_alloc_mutex")
+	->Setup(init_mutex)
+	->Teardown(shutdown_pages)
+	->Iterations(kIterations)
+	->ThreadRange(1, kMaxThreads)
+	->UseRealTime();
+
+BENCHMARK(BM_page_alloc)
+	->Name("BM_page_alloc_thread_chunk")
+	->Setup(init_thread_chunks)
+	->Teardown(shutdown_pages)
+	->Iterations(kIterations)
+	->ThreadRange(1, kMaxThreads)
+	->UseRealTime();
+
+int main(int argc, char**argv){
+	std::cout << "hardware threads: "
+		<< std::thread::hardware_concurrency() << std::endl;
+
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
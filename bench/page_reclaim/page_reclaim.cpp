@@ -0,0 +1,76 @@
+#include<cstdint>
+#include<cstring>
+
+#include<core/memory/page_allocator.hpp>
+#include<core/memory/page_worker.hpp>
+
+#include<benchmark/benchmark.h>
+
+using namespace engine::mem::allocator;
+using engine::mem::os::ReclaimMode;
+
+// a level worth of touched pages handed back on unload
+constexpr std::size_t kBytes = std::size_t{256} * 1024 * 1024;
+
+// time spent inside reset(true) on the calling thread, the touch that
+//	refills the range and the worker draining run untimed
+static void run_reset(benchmark::State& state, PageWorker* worker, ReclaimMode mode){
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = kBytes;
+	desc.worker = worker;
+	desc.reclaim_mode = mode;
+
+	PageAllocator pages;
+	pages.init(desc);
+
+	for(auto _ : state){
+		state.PauseTiming();
+		void* p = pages.allocate(kBytes, 64);
+		if(!p){
+			state.SkipWithError("allocation failed");
+			return;
+		}
+		std::memset(p, 1, kBytes);
+		benchmark::ClobberMemory();
+		state.ResumeTiming();
+
+		pages.reset(true);
+
+		state.PauseTiming();
+		if(worker) worker->flush();
+		state.ResumeTiming();
+	}
+	state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * kBytes));
+}
+
+static void BM_reset_sync(benchmark::State& state){
+	run_reset(state, nullptr, ReclaimMode::Decommit);
+}
+
+static void BM_reset_worker(benchmark::State& state){
+	PageWorker worker;
+	run_reset(state, &worker, ReclaimMode::Decommit);
+}
+
+static void BM_reset_sync_lazy_free(benchmark::State& state){
+	run_reset(state, nullptr, ReclaimMode::LazyFree);
+}
+
+static void BM_reset_worker_lazy_free(benchmark::State& state){
+	PageWorker worker;
+	run_reset(state, &worker, ReclaimMode::LazyFree);
+}
+
+BENCHMARK(BM_reset_sync)->Unit(benchmark::kMicrosecond)->Iterations(20);
+BENCHMARK(BM_reset_worker)->Unit(benchmark::kMicrosecond)->Iterations(20);
+BENCHMARK(BM_reset_sync_lazy_free)->Unit(benchmark::kMicrosecond)->Iterations(20);
+BENCHMARK(BM_reset_worker_lazy_free)->Unit(benchmark::kMicrosecond)->Iterations(20);
+
+int main(int argc, char**argv){
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+#include<iostream>
+#include<mutex>
+#include<thread>
+
+#include<core/memory/page_allocator.hpp>
+#include<core/memory/pool_allocator.hpp>
+#include<core/memory/concurrent_pool_allocator.hpp>
+
+#include<benchmark/benchmark.h>
+
+using namespace engine::mem::allocator;
+
+// each iteration grabs a small batch and gives it back, which is what
+// particle and job systems do with their per-frame objects
+constexpr std::size_t kElemSize = 64;
+constexpr std::size_t kBatch = 16;
+constexpr std::size_t kCapacity = 32 * kBatch;
+
+struct LockedPool{
+	PoolAllocator pool;
+	std::mutex mutex;
+
+	explicit LockedPool(PageAllocator& backing)
+		: pool(backing, kElemSize, kCapacity) {}
+
+	void* allocate(std::size_t size, std::size_t align){
+		std::lock_guard<std::mutex> lock(mutex);
+		return pool.allocate(size, align);
+	}
+
+	void deallocate(void* p){
+		std::lock_guard<std::mutex> lock(mutex);
+		pool.deallocate(p);
+	}
+};
+
+struct BenchData{
+	PageAllocator pages;
+	LockedPool* locked = nullptr;
+	ConcurrentPoolAllocator* concurrent = nullptr;
+
+	BenchData(){
+		pages.init(4 * 1024 * 1024);
+		locked = new LockedPool(pages);
+		concurrent = new ConcurrentPoolAllocator(pages, kElemSize, kCapacity);
+	}
+	~BenchData(){
+		delete concurrent;
+		delete locked;
+	}
+};
+
+BenchData g_data;
+
+template<typename Pool>
+static void run_batches(benchmark::State& state, Pool& pool){
+	void* held[kBatch];
+	for(auto _ : state){
+		for(std::size_t i = 0; i < kBatch; ++i){
+			held[i] = pool.allocate(kElemSize, 8);
+		}
+		benchmark::DoNotOptimize(held);
+		for(std::size_t i = 0; i < kBatch; ++i){
+			pool.deallocate(held[i]);
+		}
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(
+		state.iterations() * kBatch));
+}
+
+static void BM_mutex_pool(benchmark::State& state){
+	run_batches(state, *g_data.locked);
+}
+BENCHMARK(BM_mutex_pool)->ThreadRange(1, 32)->UseRealTime();
+
+static void BM_concurrent_pool(benchmark::State& state){
+	run_batches(state, *g_data.concurrent);
+}
+BENCHMARK(BM_concurrent_pool)->ThreadRange(1, 32)->UseRealTime();
+
+int main(int argc, char**argv){
+	std::cout << "hardware threads: "
+		<< std::thread::hardware_concurrency() << std::endl;
+
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
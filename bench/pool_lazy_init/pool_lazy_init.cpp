@@ -0,0 +1,120 @@
+#include<iostream>
+#include<fstream>
+#include<cstdint>
+
+#include<core/memory/page_allocator.hpp>
+#include<core/memory/pool_allocator.hpp>
+#include<core/memory/allocator_utils.hpp>
+
+#include<benchmark/benchmark.h>
+
+using namespace engine::mem::allocator;
+using namespace engine::mem;
+
+constexpr std::size_t kElemSize = 64;
+constexpr std::size_t kCount = 100000;
+constexpr std::size_t kReserve = 16 * 1024 * 1024;
+
+static std::size_t resident_bytes(){
+#if defined(__linux__)
+	std::ifstream statm("/proc/self/statm");
+	std::size_t total = 0, resident = 0;
+	statm >> total >> resident;
+	return resident * os::VirtualMemory::get_page_size();
+#else
+	return 0;
+#endif
+}
+
+// the previous PoolAllocator threaded a next pointer through every slot
+// on construction and on every reset, kept here as the reference
+static void* eager_init_free_list(std::byte* memory){
+	for(std::size_t i = 0; i < kCount - 1; ++i){
+		void* curr = utils::ptr_add<void>(memory, i * kElemSize);
+		*static_cast<void**>(curr) = utils::ptr_add<void>(memory, (i+1) * kElemSize);
+	}
+	*utils::ptr_add<void*>(memory, (kCount - 1) * kElemSize) = nullptr;
+	return memory;
+}
+
+static void BM_eager_construct(benchmark::State& state){
+	std::size_t rss_delta = 0;
+	for(auto _ : state){
+		state.PauseTiming();
+		PageAllocator pages;
+		pages.init(kReserve);
+		const std::size_t before = resident_bytes();
+		state.ResumeTiming();
+
+		auto* memory = static_cast<std::byte*>(
+			pages.allocate(kElemSize * kCount, kElemSize));
+		void* head = eager_init_free_list(memory);
+		benchmark::DoNotOptimize(head);
+
+		state.PauseTiming();
+		rss_delta += resident_bytes() - before;
+		state.ResumeTiming();
+	}
+	state.counters["rss_kb"] = benchmark::Counter(
+		static_cast<double>(rss_delta) / 1024.0,
+		benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_eager_construct)->Unit(benchmark::kMicrosecond);
+
+static void BM_lazy_construct(benchmark::State& state){
+	std::size_t rss_delta = 0;
+	for(auto _ : state){
+		state.PauseTiming();
+		PageAllocator pages;
+		pages.init(kReserve);
+		const std::size_t before = resident_bytes();
+		state.ResumeTiming();
+
+		PoolAllocator pool(pages, kElemSize, kCount, kElemSize);
+		auto* p = static_cast<char*>(pool.allocate(kElemSize, kElemSize));
+		*p = 1;
+		benchmark::DoNotOptimize(p);
+
+		state.PauseTiming();
+		rss_delta += resident_bytes() - before;
+		state.ResumeTiming();
+	}
+	state.counters["rss_kb"] = benchmark::Counter(
+		static_cast<double>(rss_delta) / 1024.0,
+		benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_lazy_construct)->Unit(benchmark::kMicrosecond);
+
+static void BM_eager_reset(benchmark::State& state){
+	PageAllocator pages;
+	pages.init(kReserve);
+	auto* memory = static_cast<std::byte*>(
+		pages.allocate(kElemSize * kCount, kElemSize));
+
+	for(auto _ : state){
+		void* head = eager_init_free_list(memory);
+		benchmark::DoNotOptimize(head);
+	}
+}
+BENCHMARK(BM_eager_reset)->Unit(benchmark::kMicrosecond);
+
+static void BM_lazy_reset(benchmark::State& state){
+	PageAllocator pages;
+	pages.init(kReserve);
+	PoolAllocator pool(pages, kElemSize, kCount, kElemSize);
+
+	for(auto _ : state){
+		pool.reset();
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_lazy_reset)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char**argv){
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include<algorithm>
+#include<chrono>
+#include<cstdint>
+#include<cstdlib>
+#include<vector>
+
+#include<core/memory/page_allocator.hpp>
+#include<core/memory/tlsf_allocator.hpp>
+#include<core/memory/default_heap.hpp>
+
+#include<benchmark/benchmark.h>
+
+using namespace engine::mem::allocator;
+
+// steady state churn: a working set of live blocks of mixed size, every
+// step frees a random victim and allocates a replacement
+constexpr std::size_t kLive = 4096;
+constexpr std::size_t kStepsPerIteration = 1 << 16;
+constexpr std::size_t kMaxSize = 8 * 1024;
+constexpr std::size_t kRegion = 128 * 1024 * 1024;
+
+struct Malloc{
+	void* allocate(std::size_t size, std::size_t){ return std::malloc(size); }
+	void deallocate(void* p){ std::free(p); }
+};
+
+struct Rng{
+	std::uint64_t x = 0x9E3779B97F4A7C15ull;
+	std::uint64_t next(){
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		return x;
+	}
+	// skewed towards small blocks like real engine traffic
+	std::size_t size(){
+		const std::uint64_t r = next();
+		return 16 + (r % ((r >> 32) & 1 ? 256 : kMaxSize));
+	}
+};
+
+static double percentile(std::vector<std::uint32_t>& samples, double q){
+	const auto k = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1));
+	std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(k), samples.end());
+	return samples[k];
+}
+
+template<typename Alloc>
+static void run_churn(benchmark::State& state, Alloc& alloc){
+	Rng rng;
+	std::vector<void*> live(kLive);
+	for(auto& p : live) p = alloc.allocate(rng.size(), 16);
+
+	std::vector<std::uint32_t> samples;
+	samples.reserve(kStepsPerIteration);
+
+	std::vector<std::uint32_t> all;
+	for(auto _ : state){
+		samples.clear();
+		for(std::size_t i = 0; i < kStepsPerIteration; ++i){
+			const std::size_t victim = rng.next() % kLive;
+			const std::size_t size = rng.size();
+
+			const auto t0 = std::chrono::steady_clock::now();
+			alloc.deallocate(live[victim]);
+			live[victim] = alloc.allocate(size, 16);
+			const auto t1 = std::chrono::steady_clock::now();
+
+			samples.push_back(static_cast<std::uint32_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+		}
+		benchmark::DoNotOptimize(live);
+
+		state.PauseTiming();
+		all.insert(all.end(), samples.begin(), samples.end());
+		state.ResumeTiming();
+	}
+
+	for(void* p : live) alloc.deallocate(p);
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kStepsPerIteration));
+	state.counters["p50_ns"] = percentile(all, 0.50);
+	state.counters["p99_ns"] = percentile(all, 0.99);
+	state.counters["p99.9_ns"] = percentile(all, 0.999);
+	state.counters["max_ns"] = *std::max_element(all.begin(), all.end());
+}
+
+static void BM_tlsf(benchmark::State& state){
+	PageAllocator pages;
+	pages.init(kRegion);
+	TlsfAllocator tlsf(pages, kRegion);
+	run_churn(state, tlsf);
+}
+BENCHMARK(BM_tlsf)->Unit(benchmark::kMicrosecond);
+
+static void BM_default_heap(benchmark::State& state){
+	DefaultHeap heap;
+	run_churn(state, heap);
+}
+BENCHMARK(BM_default_heap)->Unit(benchmark::kMicrosecond);
+
+static void BM_malloc(benchmark::State& state){
+	Malloc heap;
+	run_churn(state, heap);
+}
+BENCHMARK(BM_malloc)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char**argv){
+	::benchmark::Initialize(&argc, argv);
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+
+	return 0;
+}
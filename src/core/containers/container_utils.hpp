@@ -0,0 +1,55 @@
+#pragma once
+
+#include<cstddef>
+#include<cstring>
+#include<memory>
+#include<new>
+#include<type_traits>
+#include<utility>
+
+#include<core/memory/allocator_utils.hpp>
+#include<core/memory/allocator_handle.hpp>
+
+namespace engine::containers{
+
+using mem::allocator::AllocatorHandle;
+
+// a type is trivially relocatable when moving it to a new address and
+//	forgetting the old one is a plain memcpy, true for trivially copyable
+//	types, specialize it for types like owning handles that qualify too
+template<typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template<typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+//moves n objects from src into raw memory at dst, src is left raw
+template<typename T>
+void relocate(T* dst, T* src, std::size_t n) noexcept{
+	static_assert(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>,
+		"containers need trivially relocatable or nothrow movable elements");
+
+	if constexpr(is_trivially_relocatable_v<T>){
+		if(n) std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+	}
+	else{
+		for(std::size_t i = 0; i < n; ++i){
+			::new(static_cast<void*>(dst + i)) T(std::move(src[i]));
+			src[i].~T();
+		}
+	}
+}
+
+template<typename T>
+void destroy_n(T* p, std::size_t n) noexcept{
+	if constexpr(!std::is_trivially_destructible_v<T>){
+		for(std::size_t i = 0; i < n; ++i) p[i].~T();
+	}
+}
+
+template<typename T, typename Alloc>
+[[nodiscard]] T* allocate_n(Alloc& alloc, std::size_t n) noexcept{
+	return static_cast<T*>(alloc.allocate(n * sizeof(T), alignof(T)));
+}
+
+} // namespace engine::containers
@@ -0,0 +1,153 @@
+#pragma once
+
+#include<cassert>
+#include<cstddef>
+
+#include"container_utils.hpp"
+
+namespace engine::containers{
+
+// growable array on an engine allocator
+//	growth doubles the capacity and relocates with memcpy when the
+//	element type allows it, nothing throws: operations that may need
+//	memory report failure through their return value
+template<typename T, mem::utils::HandleLike Alloc = AllocatorHandle>
+class DynamicArray{
+public:
+	explicit DynamicArray(Alloc alloc) noexcept : alloc_(alloc){}
+	~DynamicArray() noexcept {release();}
+
+	DynamicArray(const DynamicArray&) = delete;
+	DynamicArray& operator=(const DynamicArray&) = delete;
+
+	DynamicArray(DynamicArray&& other) noexcept
+			: alloc_(other.alloc_), data_(other.data_),
+			size_(other.size_), capacity_(other.capacity_){
+		other.data_ = nullptr;
+		other.size_ = 0;
+		other.capacity_ = 0;
+	}
+
+	DynamicArray& operator=(DynamicArray&& other) noexcept{
+		if(this != &other){
+			release();
+			alloc_ = other.alloc_;
+			data_ = other.data_;
+			size_ = other.size_;
+			capacity_ = other.capacity_;
+			other.data_ = nullptr;
+			other.size_ = 0;
+			other.capacity_ = 0;
+		}
+		return *this;
+	}
+
+	[[nodiscard]] bool reserve(std::size_t n) noexcept{
+		if(n <= capacity_) return true;
+
+		T* fresh = allocate_n<T>(alloc_, n);
+		if(!fresh) return false;
+
+		relocate(fresh, data_, size_);
+		if(data_) alloc_.deallocate(data_);
+		data_ = fresh;
+		capacity_ = n;
+		return true;
+	}
+
+	//new elements are value initialized
+	[[nodiscard]] bool resize(std::size_t n) noexcept{
+		if(n > capacity_ && !reserve(n)) return false;
+		for(std::size_t i = size_; i < n; ++i) ::new(static_cast<void*>(data_ + i)) T();
+		if(n < size_) destroy_n(data_ + n, size_ - n);
+		size_ = n;
+		return true;
+	}
+
+	//nullptr when out of memory
+	template<typename... Args>
+	T* emplace_back(Args&&... args) noexcept{
+		if(size_ == capacity_){
+			return grow_and_emplace(std::forward<Args>(args)...);
+		}
+		return ::new(static_cast<void*>(data_ + size_++)) T(std::forward<Args>(args)...);
+	}
+
+	bool push_back(const T& v) noexcept {return emplace_back(v) != nullptr;}
+	bool push_back(T&& v) noexcept {return emplace_back(std::move(v)) != nullptr;}
+
+	void pop_back() noexcept{
+		assert(size_ > 0 && "pop_back on empty DynamicArray");
+		data_[--size_].~T();
+	}
+
+	//O(1), moves the last element into the hole
+	void erase_swap(std::size_t i) noexcept{
+		assert(i < size_ && "index out of range");
+		if(i != size_ - 1) data_[i] = std::move(data_[size_ - 1]);
+		pop_back();
+	}
+
+	void clear() noexcept{
+		destroy_n(data_, size_);
+		size_ = 0;
+	}
+
+	[[nodiscard]] T& operator[](std::size_t i) noexcept{
+		assert(i < size_ && "index out of range");
+		return data_[i];
+	}
+	[[nodiscard]] const T& operator[](std::size_t i) const noexcept{
+		assert(i < size_ && "index out of range");
+		return data_[i];
+	}
+
+	[[nodiscard]] T& front() noexcept {return (*this)[0];}
+	[[nodiscard]] T& back() noexcept {return (*this)[size_ - 1];}
+
+	[[nodiscard]] T* data() noexcept {return data_;}
+	[[nodiscard]] const T* data() const noexcept {return data_;}
+	[[nodiscard]] T* begin() noexcept {return data_;}
+	[[nodiscard]] T* end() noexcept {return data_ + size_;}
+	[[nodiscard]] const T* begin() const noexcept {return data_;}
+	[[nodiscard]] const T* end() const noexcept {return data_ + size_;}
+
+	[[nodiscard]] std::size_t size() const noexcept {return size_;}
+	[[nodiscard]] std::size_t capacity() const noexcept {return capacity_;}
+	[[nodiscard]] bool empty() const noexcept {return size_ == 0;}
+	[[nodiscard]] const Alloc& allocator() const noexcept {return alloc_;}
+
+private:
+	// args may refer to an element, build the new one before the old
+	//	buffer is relocated and freed
+	template<typename... Args>
+	T* grow_and_emplace(Args&&... args) noexcept{
+		const std::size_t n = capacity_ ? capacity_ * 2 : kMinCapacity;
+		T* fresh = allocate_n<T>(alloc_, n);
+		if(!fresh) return nullptr;
+
+		T* added = ::new(static_cast<void*>(fresh + size_)) T(std::forward<Args>(args)...);
+		relocate(fresh, data_, size_);
+		if(data_) alloc_.deallocate(data_);
+		data_ = fresh;
+		capacity_ = n;
+		++size_;
+		return added;
+	}
+
+	void release() noexcept{
+		clear();
+		if(data_) alloc_.deallocate(data_);
+		data_ = nullptr;
+		capacity_ = 0;
+	}
+
+	static constexpr std::size_t kMinCapacity = 8;
+
+	Alloc alloc_;
+	T* data_ = nullptr;
+	std::size_t size_ = 0;
+	std::size_t capacity_ = 0;
+};
+
+} // namespace engine::containers
@@ -0,0 +1,99 @@
+#pragma once
+
+#include<cassert>
+#include<cstddef>
+
+#include"container_utils.hpp"
+
+namespace engine::containers{
+
+// array with inline storage for up to N elements and a running size
+//	never allocates, push_back reports a full array by returning false
+template<typename T, std::size_t N>
+class FixedArray{
+public:
+	FixedArray() noexcept = default;
+	~FixedArray() noexcept {clear();}
+
+	FixedArray(const FixedArray& other) noexcept(std::is_nothrow_copy_constructible_v<T>){
+		for(const T& v : other) emplace_back(v);
+	}
+	FixedArray& operator=(const FixedArray& other) noexcept(std::is_nothrow_copy_constructible_v<T>){
+		if(this != &other){
+			clear();
+			for(const T& v : other) emplace_back(v);
+		}
+		return *this;
+	}
+
+	FixedArray(FixedArray&& other) noexcept{
+		relocate(data(), other.data(), other.size_);
+		size_ = other.size_;
+		other.size_ = 0;
+	}
+	FixedArray& operator=(FixedArray&& other) noexcept{
+		if(this != &other){
+			clear();
+			relocate(data(), other.data(), other.size_);
+			size_ = other.size_;
+			other.size_ = 0;
+		}
+		return *this;
+	}
+
+	//nullptr when full
+	template<typename... Args>
+	T* emplace_back(Args&&... args) noexcept{
+		if(size_ == N) return nullptr;
+		return ::new(static_cast<void*>(data() + size_++)) T(std::forward<Args>(args)...);
+	}
+
+	bool push_back(const T& v) noexcept {return emplace_back(v) != nullptr;}
+	bool push_back(T&& v) noexcept {return emplace_back(std::move(v)) != nullptr;}
+
+	void pop_back() noexcept{
+		assert(size_ > 0 && "pop_back on empty FixedArray");
+		data()[--size_].~T();
+	}
+
+	//O(1), moves the last element into the hole
+	void erase_swap(std::size_t i) noexcept{
+		assert(i < size_ && "index out of range");
+		if(i != size_ - 1) data()[i] = std::move(data()[size_ - 1]);
+		pop_back();
+	}
+
+	void clear() noexcept{
+		destroy_n(data(), size_);
+		size_ = 0;
+	}
+
+	[[nodiscard]] T& operator[](std::size_t i) noexcept{
+		assert(i < size_ && "index out of range");
+		return data()[i];
+	}
+	[[nodiscard]] const T& operator[](std::size_t i) const noexcept{
+		assert(i < size_ && "index out of range");
+		return data()[i];
+	}
+
+	[[nodiscard]] T* data() noexcept {return std::launder(reinterpret_cast<T*>(storage_));}
+	[[nodiscard]] const T* data() const noexcept {
+		return std::launder(reinterpret_cast<const T*>(storage_));
+	}
+	[[nodiscard]] T* begin() noexcept {return data();}
+	[[nodiscard]] T* end() noexcept {return data() + size_;}
+	[[nodiscard]] const T* begin() const noexcept {return data();}
+	[[nodiscard]] const T* end() const noexcept {return data() + size_;}
+
+	[[nodiscard]] std::size_t size() const noexcept {return size_;}
+	[[nodiscard]] static constexpr std::size_t capacity() noexcept {return N;}
+	[[nodiscard]] bool empty() const noexcept {return size_ == 0;}
+	[[nodiscard]] bool full() const noexcept {return size_ == N;}
+
+private:
+	alignas(T) std::byte storage_[N * sizeof(T)];
+	std::size_t size_ = 0;
+};
+
+} // namespace engine::containers
@@ -0,0 +1,336 @@
+#pragma once
+
+#include<algorithm>
+#include<bit>
+#include<cassert>
+#include<cstddef>
+#include<cstdint>
+#include<functional>
+#include<utility>
+
+#include<core/math/simd_backend.hpp>
+
+#include"container_utils.hpp"
+
+namespace engine::containers{
+
+// swiss table style open addressing hash map on an engine allocator
+//	every slot has a control byte: empty, deleted or the low 7 bits of
+//	its hash, control bytes are probed 16 at a time with the simd byte
+//	group helpers so most misses and hits cost one compare of a group,
+//	failure to allocate is reported through return values
+template<typename K,
+	typename V,
+	typename Hash = std::hash<K>,
+	typename Eq = std::equal_to<K>,
+	mem::utils::HandleLike Alloc = AllocatorHandle>
+class HashMap{
+public:
+	struct Entry{
+		K key;
+		V value;
+	};
+
+	explicit HashMap(Alloc alloc, Hash hash = Hash{}, Eq eq = Eq{}) noexcept
+		: alloc_(alloc), hash_(hash), eq_(eq){}
+	~HashMap() noexcept {release();}
+
+	HashMap(const HashMap&) = delete;
+	HashMap& operator=(const HashMap&) = delete;
+
+	HashMap(HashMap&& other) noexcept
+			: alloc_(other.alloc_), hash_(other.hash_), eq_(other.eq_){
+		steal(other);
+	}
+
+	HashMap& operator=(HashMap&& other) noexcept{
+		if(this != &other){
+			release();
+			alloc_ = other.alloc_;
+			hash_ = other.hash_;
+			eq_ = other.eq_;
+			steal(other);
+		}
+		return *this;
+	}
+
+	//room for n entries without rehashing
+	[[nodiscard]] bool reserve(std::size_t n) noexcept{
+		std::size_t cap = capacity_ ? capacity_ : kGroupWidth;
+		while(n > max_load(cap)) cap *= 2;
+		return cap == capacity_ || rehash(cap);
+	}
+
+	//{value, inserted}, {nullptr, false} when out of memory
+	template<typename... Args>
+	std::pair<V*, bool> try_emplace(const K& key, Args&&... args) noexcept{
+		const std::uint64_t h = mix(key);
+		const std::size_t found = index_of(key, h);
+		if(found != kNotFound) return {&slots_[found].value, false};
+
+		if(growth_left_ == 0 && !make_room()){
+			return {nullptr, false};
+		}
+
+		const std::size_t i = free_index(h);
+		if(ctrl_[i] == kEmpty) --growth_left_;
+		ctrl_[i] = h2(h);
+
+		Entry* e = ::new(static_cast<void*>(slots_ + i))
+			Entry{key, V(std::forward<Args>(args)...)};
+		++size_;
+		return {&e->value, true};
+	}
+
+	V* insert_or_assign(const K& key, V value) noexcept{
+		auto [v, inserted] = try_emplace(key, std::move(value));
+		if(v && !inserted) *v = std::move(value);
+		return v;
+	}
+
+	[[nodiscard]] V* find(const K& key) noexcept{
+		const std::size_t i = index_of(key, mix(key));
+		return i == kNotFound ? nullptr : &slots_[i].value;
+	}
+	[[nodiscard]] const V* find(const K& key) const noexcept{
+		const std::size_t i = index_of(key, mix(key));
+		return i == kNotFound ? nullptr : &slots_[i].value;
+	}
+	[[nodiscard]] bool contains(const K& key) const noexcept{
+		return index_of(key, mix(key)) != kNotFound;
+	}
+
+	bool erase(const K& key) noexcept{
+		const std::size_t i = index_of(key, mix(key));
+		if(i == kNotFound) return false;
+
+		slots_[i].~Entry();
+		--size_;
+
+		// a group that still has an empty byte ends every probe reaching
+		// it, so the slot can go back to empty instead of a tombstone
+		const std::size_t group = i & ~(kGroupWidth - 1);
+		if(math::simd::match_byte(math::simd::load_bytes(ctrl_ + group), kEmpty)){
+			ctrl_[i] = kEmpty;
+			++growth_left_;
+		}
+		else{
+			ctrl_[i] = kDeleted;
+		}
+		return true;
+	}
+
+	void clear() noexcept{
+		for(std::size_t i = 0; i < capacity_; ++i){
+			if(is_full(ctrl_[i])) slots_[i].~Entry();
+		}
+		if(ctrl_) std::memset(ctrl_, kEmpty, capacity_);
+		size_ = 0;
+		growth_left_ = max_load(capacity_);
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept {return size_;}
+	[[nodiscard]] std::size_t capacity() const noexcept {return capacity_;}
+	[[nodiscard]] bool empty() const noexcept {return size_ == 0;}
+
+	template<typename MapT, typename EntryT>
+	class Iterator{
+	public:
+		Iterator(MapT* map, std::size_t i) noexcept : map_(map), i_(i) {skip();}
+
+		EntryT& operator*() const noexcept {return map_->slots_[i_];}
+		EntryT* operator->() const noexcept {return &map_->slots_[i_];}
+		Iterator& operator++() noexcept {++i_; skip(); return *this;}
+		bool operator==(const Iterator& o) const noexcept {return i_ == o.i_;}
+
+	private:
+		void skip() noexcept{
+			while(i_ < map_->capacity_ && !is_full(map_->ctrl_[i_])) ++i_;
+		}
+
+		MapT* map_;
+		std::size_t i_;
+	};
+
+	//keys must not be changed through the iterator
+	using iterator = Iterator<HashMap, Entry>;
+	using const_iterator = Iterator<const HashMap, const Entry>;
+
+	[[nodiscard]] iterator begin() noexcept {return iterator(this, 0);}
+	[[nodiscard]] iterator end() noexcept {return iterator(this, capacity_);}
+	[[nodiscard]] const_iterator begin() const noexcept {return const_iterator(this, 0);}
+	[[nodiscard]] const_iterator end() const noexcept {return const_iterator(this, capacity_);}
+
+private:
+	static constexpr std::size_t kGroupWidth = 16;
+	static constexpr std::uint8_t kEmpty = 0x80;
+	static constexpr std::uint8_t kDeleted = 0xFE;
+	static constexpr std::size_t kNotFound = ~std::size_t{0};
+
+	//7/8 of the slots may hold entries or tombstones
+	static constexpr std::size_t max_load(std::size_t capacity) noexcept{
+		return capacity - capacity / 8;
+	}
+
+	static constexpr bool is_full(std::uint8_t c) noexcept {return (c & 0x80) == 0;}
+
+	//std::hash of integers is the identity, mix so both halves are usable
+	std::uint64_t mix(const K& key) const noexcept{
+		std::uint64_t h = static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+		return h ^ (h >> 32);
+	}
+	static std::uint8_t h2(std::uint64_t h) noexcept{
+		return static_cast<std::uint8_t>(h & 0x7F);
+	}
+	std::size_t first_group(std::uint64_t h) const noexcept{
+		return static_cast<std::size_t>(h >> 7) & group_mask_;
+	}
+
+	// groups are visited in triangular steps, which covers every group
+	// of a power of two table
+	std::size_t index_of(const K& key, std::uint64_t h) const noexcept{
+		if(!size_) return kNotFound;
+
+		const std::uint8_t tag = h2(h);
+		std::size_t g = first_group(h);
+		for(std::size_t step = 1;; ++step){
+			const auto group = math::simd::load_bytes(ctrl_ + g * kGroupWidth);
+			for(std::uint32_t m = math::simd::match_byte(group, tag); m; m &= m - 1){
+				const std::size_t i = g * kGroupWidth
+					+ static_cast<std::size_t>(std::countr_zero(m));
+				if(eq_(slots_[i].key, key)) return i;
+			}
+			if(math::simd::match_byte(group, kEmpty)) return kNotFound;
+			g = (g + step) & group_mask_;
+		}
+	}
+
+	//first empty or deleted slot on the probe sequence of h
+	std::size_t free_index(std::uint64_t h) const noexcept{
+		std::size_t g = first_group(h);
+		for(std::size_t step = 1;; ++step){
+			const auto group = math::simd::load_bytes(ctrl_ + g * kGroupWidth);
+			if(const std::uint32_t m = math::simd::match_high_bit(group)){
+				return g * kGroupWidth + static_cast<std::size_t>(std::countr_zero(m));
+			}
+			g = (g + step) & group_mask_;
+		}
+	}
+
+	//doubles when live entries use over half the load, else only drops
+	//	tombstones, in place so arena backed maps do not leak a table
+	bool make_room() noexcept{
+		if(capacity_ && size_ + 1 <= max_load(capacity_) / 2){
+			drop_tombstones();
+			return true;
+		}
+		return rehash(capacity_ ? capacity_ * 2 : kGroupWidth);
+	}
+
+	// tombstones become empty and live entries are marked deleted, then
+	//	each marked entry goes to the first free slot of its probe
+	//	sequence, staying put when that is in its own group and trading
+	//	places when it lands on another entry still waiting to move
+	void drop_tombstones() noexcept{
+		for(std::size_t i = 0; i < capacity_; ++i){
+			ctrl_[i] = is_full(ctrl_[i]) ? kDeleted : kEmpty;
+		}
+
+		for(std::size_t i = 0; i < capacity_; ++i){
+			if(ctrl_[i] != kDeleted) continue;
+
+			const std::uint64_t h = mix(slots_[i].key);
+			const std::size_t j = free_index(h);
+			if(j / kGroupWidth == i / kGroupWidth){
+				ctrl_[i] = h2(h);
+				continue;
+			}
+
+			if(ctrl_[j] == kEmpty){
+				relocate(slots_ + j, slots_ + i, 1);
+				ctrl_[i] = kEmpty;
+			}
+			else{
+				alignas(Entry) std::byte tmp[sizeof(Entry)];
+				Entry* t = reinterpret_cast<Entry*>(tmp);
+				relocate(t, slots_ + j, 1);
+				relocate(slots_ + j, slots_ + i, 1);
+				relocate(slots_ + i, t, 1);
+				// the entry swapped into i still has to move
+				--i;
+			}
+			ctrl_[j] = h2(h);
+		}
+
+		growth_left_ = max_load(capacity_) - size_;
+	}
+
+	bool rehash(std::size_t new_capacity) noexcept{
+		const std::size_t ctrl_bytes = mem::utils::align_up(new_capacity, alignof(Entry));
+		auto* block = static_cast<std::byte*>(alloc_.allocate(
+			ctrl_bytes + new_capacity * sizeof(Entry),
+			std::max<std::size_t>(alignof(Entry), kGroupWidth)));
+		if(!block) return false;
+
+		std::uint8_t* old_ctrl = ctrl_;
+		Entry* old_slots = slots_;
+		const std::size_t old_capacity = capacity_;
+
+		ctrl_ = reinterpret_cast<std::uint8_t*>(block);
+		slots_ = reinterpret_cast<Entry*>(block + ctrl_bytes);
+		std::memset(ctrl_, kEmpty, new_capacity);
+		capacity_ = new_capacity;
+		group_mask_ = new_capacity / kGroupWidth - 1;
+		growth_left_ = max_load(new_capacity) - size_;
+
+		for(std::size_t i = 0; i < old_capacity; ++i){
+			if(!is_full(old_ctrl[i])) continue;
+			const std::uint64_t h = mix(old_slots[i].key);
+			const std::size_t j = free_index(h);
+			ctrl_[j] = h2(h);
+			relocate(slots_ + j, old_slots + i, 1);
+		}
+
+		if(old_ctrl) alloc_.deallocate(old_ctrl);
+		return true;
+	}
+
+	void steal(HashMap& other) noexcept{
+		ctrl_ = other.ctrl_;
+		slots_ = other.slots_;
+		size_ = other.size_;
+		capacity_ = other.capacity_;
+		group_mask_ = other.group_mask_;
+		growth_left_ = other.growth_left_;
+		other.ctrl_ = nullptr;
+		other.slots_ = nullptr;
+		other.size_ = 0;
+		other.capacity_ = 0;
+		other.group_mask_ = 0;
+		other.growth_left_ = 0;
+	}
+
+	void release() noexcept{
+		clear();
+		if(ctrl_) alloc_.deallocate(ctrl_);
+		ctrl_ = nullptr;
+		slots_ = nullptr;
+		capacity_ = 0;
+		group_mask_ = 0;
+		growth_left_ = 0;
+	}
+
+	Alloc alloc_;
+	[[no_unique_address]] Hash hash_;
+	[[no_unique_address]] Eq eq_;
+
+	std::uint8_t* ctrl_ = nullptr;
+	Entry* slots_ = nullptr;
+	std::size_t size_ = 0;
+	std::size_t capacity_ = 0;
+	std::size_t group_mask_ = 0;
+	//inserts left before a rehash, tombstones count as used
+	std::size_t growth_left_ = 0;
+};
+
+} // namespace engine::containers
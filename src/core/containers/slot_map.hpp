@@ -0,0 +1,172 @@
+#pragma once
+
+#include<cstddef>
+#include<cstdint>
+#include<utility>
+
+#include"container_utils.hpp"
+#include"dynamic_array.hpp"
+
+namespace engine::containers{
+
+// 32 bit handle, low bits index a slot, high bits hold its generation
+template<unsigned IndexBits = 20>
+struct SlotHandle{
+	static_assert(IndexBits > 0 && IndexBits < 32);
+
+	static constexpr std::uint32_t kIndexMask = (1u << IndexBits) - 1;
+	static constexpr std::uint32_t kMaxGeneration = (~0u) >> IndexBits;
+	static constexpr std::uint32_t kInvalid = ~0u;
+
+	std::uint32_t value = kInvalid;
+
+	constexpr SlotHandle() noexcept = default;
+	constexpr SlotHandle(std::uint32_t index, std::uint32_t generation) noexcept
+		: value((generation << IndexBits) | index){}
+
+	[[nodiscard]] constexpr std::uint32_t index() const noexcept {return value & kIndexMask;}
+	[[nodiscard]] constexpr std::uint32_t generation() const noexcept {return value >> IndexBits;}
+	[[nodiscard]] constexpr bool valid() const noexcept {return value != kInvalid;}
+
+	friend constexpr bool operator==(SlotHandle, SlotHandle) noexcept = default;
+};
+
+// objects live densely in insertion order with holes filled by the last
+//	element, handles go through a slot table holding the dense index
+//	and a generation, erase bumps the generation so stale handles miss,
+//	free slots form an intrusive list like the PoolAllocator free list
+//	a slot whose generation runs out is retired instead of reused
+template<typename T, unsigned IndexBits = 20, mem::utils::HandleLike Alloc = AllocatorHandle>
+class SlotMap{
+public:
+	using Handle = SlotHandle<IndexBits>;
+
+	explicit SlotMap(Alloc alloc) noexcept
+		: dense_(alloc), dense_to_slot_(alloc), slots_(alloc){}
+
+	// the source keeps empty arrays, so its free list must go with them
+	SlotMap(SlotMap&& other) noexcept
+			: dense_(std::move(other.dense_)),
+			dense_to_slot_(std::move(other.dense_to_slot_)),
+			slots_(std::move(other.slots_)),
+			free_head_(std::exchange(other.free_head_, kNullSlot)){}
+
+	SlotMap& operator=(SlotMap&& other) noexcept{
+		if(this != &other){
+			dense_ = std::move(other.dense_);
+			dense_to_slot_ = std::move(other.dense_to_slot_);
+			slots_ = std::move(other.slots_);
+			free_head_ = std::exchange(other.free_head_, kNullSlot);
+		}
+		return *this;
+	}
+
+	[[nodiscard]] bool reserve(std::size_t n) noexcept{
+		return dense_.reserve(n) && dense_to_slot_.reserve(n) && slots_.reserve(n);
+	}
+
+	//invalid handle when out of memory or out of indices
+	template<typename... Args>
+	Handle emplace(Args&&... args) noexcept{
+		std::uint32_t slot = free_head_;
+		if(slot == kNullSlot){
+			if(slots_.size() > Handle::kIndexMask - 1) return Handle{};
+			if(!slots_.push_back(Slot{kNullSlot, 0})) return Handle{};
+			slot = static_cast<std::uint32_t>(slots_.size() - 1);
+		}
+
+		const auto dense_index = static_cast<std::uint32_t>(dense_.size());
+		if(!dense_to_slot_.push_back(slot)) return Handle{};
+		if(!dense_.emplace_back(std::forward<Args>(args)...)){
+			dense_to_slot_.pop_back();
+			return Handle{};
+		}
+
+		if(slot == free_head_) free_head_ = slots_[slot].dense_or_next;
+		slots_[slot].dense_or_next = dense_index;
+		return Handle(slot, slots_[slot].generation);
+	}
+
+	Handle insert(const T& v) noexcept {return emplace(v);}
+	Handle insert(T&& v) noexcept {return emplace(std::move(v));}
+
+	[[nodiscard]] T* get(Handle h) noexcept{
+		const std::uint32_t d = dense_index(h);
+		return d == kNullSlot ? nullptr : &dense_[d];
+	}
+	[[nodiscard]] const T* get(Handle h) const noexcept{
+		const std::uint32_t d = dense_index(h);
+		return d == kNullSlot ? nullptr : &dense_[d];
+	}
+	[[nodiscard]] bool contains(Handle h) const noexcept {return dense_index(h) != kNullSlot;}
+
+	bool erase(Handle h) noexcept{
+		const std::uint32_t d = dense_index(h);
+		if(d == kNullSlot) return false;
+
+		// the last element fills the hole, its slot follows it
+		const std::uint32_t last_slot = dense_to_slot_[dense_.size() - 1];
+		dense_.erase_swap(d);
+		dense_to_slot_.erase_swap(d);
+		if(last_slot != h.index()) slots_[last_slot].dense_or_next = d;
+
+		Slot& s = slots_[h.index()];
+		if(++s.generation > Handle::kMaxGeneration - 1){
+			s.dense_or_next = kNullSlot;
+			return true;
+		}
+		s.dense_or_next = free_head_;
+		free_head_ = h.index();
+		return true;
+	}
+
+	void clear() noexcept{
+		while(!dense_.empty()){
+			erase(Handle(dense_to_slot_[dense_.size() - 1],
+				slots_[dense_to_slot_[dense_.size() - 1]].generation));
+		}
+	}
+
+	//handle of the object at a dense position, for iteration
+	[[nodiscard]] Handle handle_at(std::size_t dense_index) const noexcept{
+		const std::uint32_t slot = dense_to_slot_[dense_index];
+		return Handle(slot, slots_[slot].generation);
+	}
+
+	[[nodiscard]] T* begin() noexcept {return dense_.begin();}
+	[[nodiscard]] T* end() noexcept {return dense_.end();}
+	[[nodiscard]] const T* begin() const noexcept {return dense_.begin();}
+	[[nodiscard]] const T* end() const noexcept {return dense_.end();}
+	[[nodiscard]] T* data() noexcept {return dense_.data();}
+
+	[[nodiscard]] std::size_t size() const noexcept {return dense_.size();}
+	[[nodiscard]] bool empty() const noexcept {return dense_.empty();}
+	//slots ever created, including free and retired ones
+	[[nodiscard]] std::size_t slot_count() const noexcept {return slots_.size();}
+
+private:
+	static constexpr std::uint32_t kNullSlot = ~0u;
+
+	struct Slot{
+		//dense index while live, next free slot while free
+		std::uint32_t dense_or_next;
+		std::uint32_t generation;
+	};
+
+	std::uint32_t dense_index(Handle h) const noexcept{
+		if(!h.valid() || h.index() >= slots_.size()) return kNullSlot;
+		const Slot& s = slots_[h.index()];
+		if(s.generation != h.generation()) return kNullSlot;
+		// a free slot keeps its generation until reuse, check it is live
+		const std::uint32_t d = s.dense_or_next;
+		if(d >= dense_.size() || dense_to_slot_[d] != h.index()) return kNullSlot;
+		return d;
+	}
+
+	DynamicArray<T, Alloc> dense_;
+	DynamicArray<std::uint32_t, Alloc> dense_to_slot_;
+	DynamicArray<Slot, Alloc> slots_;
+	std::uint32_t free_head_ = kNullSlot;
+};
+
+} // namespace engine::containers
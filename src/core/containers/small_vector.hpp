@@ -0,0 +1,155 @@
+#pragma once
+
+#include<cassert>
+#include<cstddef>
+
+#include"container_utils.hpp"
+
+namespace engine::containers{
+
+// growable array holding its first N elements inline
+//	spills to the allocator only once it outgrows the inline storage,
+//	same failure reporting as DynamicArray
+template<typename T, std::size_t N, mem::utils::HandleLike Alloc = AllocatorHandle>
+class SmallVector{
+public:
+	explicit SmallVector(Alloc alloc) noexcept : alloc_(alloc){}
+	~SmallVector() noexcept {release();}
+
+	SmallVector(const SmallVector&) = delete;
+	SmallVector& operator=(const SmallVector&) = delete;
+
+	SmallVector(SmallVector&& other) noexcept : alloc_(other.alloc_){
+		steal(other);
+	}
+
+	SmallVector& operator=(SmallVector&& other) noexcept{
+		if(this != &other){
+			release();
+			alloc_ = other.alloc_;
+			steal(other);
+		}
+		return *this;
+	}
+
+	[[nodiscard]] bool reserve(std::size_t n) noexcept{
+		if(n <= capacity_) return true;
+
+		T* fresh = allocate_n<T>(alloc_, n);
+		if(!fresh) return false;
+
+		relocate(fresh, data_, size_);
+		if(!is_inline()) alloc_.deallocate(data_);
+		data_ = fresh;
+		capacity_ = n;
+		return true;
+	}
+
+	//nullptr when out of memory
+	template<typename... Args>
+	T* emplace_back(Args&&... args) noexcept{
+		if(size_ == capacity_){
+			return grow_and_emplace(std::forward<Args>(args)...);
+		}
+		return ::new(static_cast<void*>(data_ + size_++)) T(std::forward<Args>(args)...);
+	}
+
+	bool push_back(const T& v) noexcept {return emplace_back(v) != nullptr;}
+	bool push_back(T&& v) noexcept {return emplace_back(std::move(v)) != nullptr;}
+
+	void pop_back() noexcept{
+		assert(size_ > 0 && "pop_back on empty SmallVector");
+		data_[--size_].~T();
+	}
+
+	//O(1), moves the last element into the hole
+	void erase_swap(std::size_t i) noexcept{
+		assert(i < size_ && "index out of range");
+		if(i != size_ - 1) data_[i] = std::move(data_[size_ - 1]);
+		pop_back();
+	}
+
+	void clear() noexcept{
+		destroy_n(data_, size_);
+		size_ = 0;
+	}
+
+	[[nodiscard]] T& operator[](std::size_t i) noexcept{
+		assert(i < size_ && "index out of range");
+		return data_[i];
+	}
+	[[nodiscard]] const T& operator[](std::size_t i) const noexcept{
+		assert(i < size_ && "index out of range");
+		return data_[i];
+	}
+
+	[[nodiscard]] T* data() noexcept {return data_;}
+	[[nodiscard]] const T* data() const noexcept {return data_;}
+	[[nodiscard]] T* begin() noexcept {return data_;}
+	[[nodiscard]] T* end() noexcept {return data_ + size_;}
+	[[nodiscard]] const T* begin() const noexcept {return data_;}
+	[[nodiscard]] const T* end() const noexcept {return data_ + size_;}
+
+	[[nodiscard]] std::size_t size() const noexcept {return size_;}
+	[[nodiscard]] std::size_t capacity() const noexcept {return capacity_;}
+	[[nodiscard]] bool empty() const noexcept {return size_ == 0;}
+	//true while the elements live in the inline storage
+	[[nodiscard]] bool is_inline() const noexcept {return data_ == inline_data();}
+
+private:
+	static_assert(N > 0, "use DynamicArray for no inline storage");
+
+	T* inline_data() noexcept {return std::launder(reinterpret_cast<T*>(inline_));}
+	const T* inline_data() const noexcept {
+		return std::launder(reinterpret_cast<const T*>(inline_));
+	}
+
+	// args may refer to an element, build the new one before the old
+	//	storage is relocated and freed
+	template<typename... Args>
+	T* grow_and_emplace(Args&&... args) noexcept{
+		const std::size_t n = capacity_ * 2;
+		T* fresh = allocate_n<T>(alloc_, n);
+		if(!fresh) return nullptr;
+
+		T* added = ::new(static_cast<void*>(fresh + size_)) T(std::forward<Args>(args)...);
+		relocate(fresh, data_, size_);
+		if(!is_inline()) alloc_.deallocate(data_);
+		data_ = fresh;
+		capacity_ = n;
+		++size_;
+		return added;
+	}
+
+	void steal(SmallVector& other) noexcept{
+		if(other.is_inline()){
+			relocate(inline_data(), other.data_, other.size_);
+			data_ = inline_data();
+			capacity_ = N;
+		}
+		else{
+			data_ = other.data_;
+			capacity_ = other.capacity_;
+		}
+		size_ = other.size_;
+
+		other.data_ = other.inline_data();
+		other.size_ = 0;
+		other.capacity_ = N;
+	}
+
+	void release() noexcept{
+		clear();
+		if(!is_inline()) alloc_.deallocate(data_);
+		data_ = inline_data();
+		capacity_ = N;
+	}
+
+	Alloc alloc_;
+	T* data_ = inline_data();
+	std::size_t size_ = 0;
+	std::size_t capacity_ = N;
+	alignas(T) std::byte inline_[N * sizeof(T)];
+};
+
+} // namespace engine::containers
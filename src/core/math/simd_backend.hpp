@@ -1,6 +1,7 @@
 #pragma once
 
 #include<cmath>
+#include<cstdint>
 #include<utility>
 #include<string>
 #include<algorithm>
@@ -1335,4 +1336,64 @@ FORCE_INLINE void quat_to_mat4(
     c3 = set(0.0f, 0.0f, 0.0f, 1.0f);
 }
 
+//16 byte groups, hash table control bytes are probed a group at a time
+#if defined(ENGINE_SIMD_SSE)
+	using ByteGroup = __m128i;
+#elif defined(ENGINE_SIMD_NEON)
+	using ByteGroup = uint8x16_t;
+#else
+	struct ByteGroup {std::uint8_t b[16]; };
+#endif
+
+#if defined(ENGINE_SIMD_NEON)
+//lane i contributes bit i % 8 of its half
+[[nodiscard]] FORCE_INLINE std::uint32_t neon_bitmask(uint8x16_t lanes){
+	static constexpr std::uint8_t kBits[16] = {
+		1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+	uint8x16_t m = vandq_u8(lanes, vld1q_u8(kBits));
+	return static_cast<std::uint32_t>(vaddv_u8(vget_low_u8(m)))
+		| (static_cast<std::uint32_t>(vaddv_u8(vget_high_u8(m))) << 8);
+}
+#endif
+
+//unaligned load of 16 bytes
+[[nodiscard]] FORCE_INLINE ByteGroup load_bytes(const std::uint8_t* p){
+	#if defined(ENGINE_SIMD_SSE)
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	#elif defined(ENGINE_SIMD_NEON)
+		return vld1q_u8(p);
+	#else
+		ByteGroup g;
+		for(int i = 0; i < 16; ++i) g.b[i] = p[i];
+		return g;
+	#endif
+}
+
+//bit i set when byte i equals v
+[[nodiscard]] FORCE_INLINE std::uint32_t match_byte(ByteGroup g, std::uint8_t v){
+	#if defined(ENGINE_SIMD_SSE)
+		return static_cast<std::uint32_t>(_mm_movemask_epi8(
+			_mm_cmpeq_epi8(g, _mm_set1_epi8(static_cast<char>(v)))));
+	#elif defined(ENGINE_SIMD_NEON)
+		return neon_bitmask(vceqq_u8(g, vdupq_n_u8(v)));
+	#else
+		std::uint32_t mask = 0;
+		for(int i = 0; i < 16; ++i) mask |= static_cast<std::uint32_t>(g.b[i] == v) << i;
+		return mask;
+	#endif
+}
+
+//bit i set when the top bit of byte i is set
+[[nodiscard]] FORCE_INLINE std::uint32_t match_high_bit(ByteGroup g){
+	#if defined(ENGINE_SIMD_SSE)
+		return static_cast<std::uint32_t>(_mm_movemask_epi8(g));
+	#elif defined(ENGINE_SIMD_NEON)
+		return neon_bitmask(vcltq_s8(vreinterpretq_s8_u8(g), vdupq_n_s8(0)));
+	#else
+		std::uint32_t mask = 0;
+		for(int i = 0; i < 16; ++i) mask |= static_cast<std::uint32_t>(g.b[i] >> 7) << i;
+		return mask;
+	#endif
+}
+
 } // namespace engine::math::simd
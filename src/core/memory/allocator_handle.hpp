@@ -1,5 +1,7 @@
 #pragma once
 
+#include<new>
+
 #include"allocator_utils.hpp"
 
 namespace engine::mem::allocator{
@@ -30,6 +32,7 @@ struct AllocatorHandle{
 		};
 	}
 
+	//on a double ended arena reset clears both ends, see from_arena_bottom
 	template<typename T>
 	static AllocatorHandle from_arena(T& allocator){
 		return AllocatorHandle{
@@ -46,6 +49,40 @@ struct AllocatorHandle{
 		};
 	}
 
+	//bottom end of a double ended arena, reset clears only that end
+	template<typename T>
+	static AllocatorHandle from_arena_bottom(T& allocator){
+		return AllocatorHandle{
+			&allocator,
+			[](void* i, const std::size_t s,const std::size_t a){
+				return static_cast<T*>(i)->allocate_bottom(s,a);
+			},
+			[](void* /*i*/, void* /*p*/) {
+				/**/
+			},
+			[](void* i) {static_cast<T*>(i)->reset_bottom();},
+			false,
+			true
+		};
+	}
+
+	//top end of a double ended arena, reset clears only that end
+	template<typename T>
+	static AllocatorHandle from_arena_top(T& allocator){
+		return AllocatorHandle{
+			&allocator,
+			[](void* i, const std::size_t s,const std::size_t a){
+				return static_cast<T*>(i)->allocate_top(s,a);
+			},
+			[](void* /*i*/, void* /*p*/) {
+				/**/
+			},
+			[](void* i) {static_cast<T*>(i)->reset_top();},
+			false,
+			true
+		};
+	}
+
 	template<typename T>
 	static AllocatorHandle from_pool(T& allocator){
 		return AllocatorHandle{
@@ -77,15 +114,15 @@ struct AllocatorHandle{
 	}
 };
 
-template<typename T, typename ...Args>
-T* alloc_new(AllocatorHandle& a, Args&&... args){
+template<typename T, utils::HandleLike Handle, typename ...Args>
+T* alloc_new(Handle& a, Args&&... args){
 	void* mem = a.allocate(sizeof(T), alignof(T));
 	if(!mem) throw std::bad_alloc();
 	return new (mem) T(std::forward<Args>(args)...);
 }
 
-template<typename T>
-void free_delete(AllocatorHandle& a, T* obj) noexcept{
+template<typename T, utils::HandleLike Handle>
+void free_delete(Handle& a, T* obj) noexcept{
 	if(!obj) return;
 	obj->~T();
 	a.deallocate(static_cast<void*>(obj));
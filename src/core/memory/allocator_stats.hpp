@@ -0,0 +1,63 @@
+#pragma once
+
+#include<atomic>
+#include<cstddef>
+
+namespace engine::mem::allocator{
+
+// relaxed atomic counter with a single writer (the owning thread)
+//	any other thread may load() it for telemetry without locking,
+//	on x86/arm the updates compile to plain loads and stores
+class RelaxedCounter{
+public:
+	RelaxedCounter() noexcept = default;
+	RelaxedCounter(std::size_t v) noexcept : value_(v) {}
+	RelaxedCounter(const RelaxedCounter& other) noexcept : value_(other.load()) {}
+	RelaxedCounter& operator=(const RelaxedCounter& other) noexcept{
+		store(other.load());
+		return *this;
+	}
+
+	[[nodiscard]] std::size_t load() const noexcept{
+		return value_.load(std::memory_order_relaxed);
+	}
+	void store(std::size_t v) noexcept{
+		value_.store(v, std::memory_order_relaxed);
+	}
+
+	void add(std::size_t n = 1) noexcept { store(load() + n); }
+	void sub(std::size_t n = 1) noexcept { store(load() - n); }
+	void raise_to(std::size_t v) noexcept { if(v > load()) store(v); }
+
+private:
+	std::atomic<std::size_t> value_ = 0;
+};
+
+struct PoolStats{
+	std::size_t capacity = 0;
+	std::size_t live = 0;
+	std::size_t free = 0;
+	std::size_t high_water = 0;
+	std::size_t failed_allocs = 0;
+};
+
+struct ArenaStats{
+	std::size_t capacity = 0;
+	std::size_t in_use = 0;
+	std::size_t peak = 0;
+	std::size_t resets = 0;
+};
+
+struct PageAllocatorStats{
+	std::size_t reserved = 0;
+	std::size_t committed = 0;
+	std::size_t peak_committed = 0;
+	std::size_t commit_calls = 0;
+	std::size_t decommit_calls = 0;
+	std::size_t prefaulted = 0;
+	//freed out of order and waiting for reuse
+	std::size_t free_bytes = 0;
+	std::size_t free_ranges = 0;
+};
+
+} // namespace engine::mem::allocator
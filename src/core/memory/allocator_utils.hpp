@@ -35,9 +35,25 @@ concept AllocatorLike = requires(
 template<typename T>
 concept ArenaLike = AllocatorLike<T> && requires(T& a) {a.reset();};
 
+template<typename T>
+concept MarkerArenaLike = ArenaLike<T> && requires(T& a) {
+	a.rollback(a.get_marker());
+};
+
+//anything alloc_new / free_delete can go through
+template<typename T>
+concept HandleLike = AllocatorLike<T> && requires(T& a, void*p) {a.deallocate(p);};
+
 template<typename T>
 concept PoolLike = AllocatorLike<T> && requires(T& p) { 
 	{p.capacity() } -> std::convertible_to<std::size_t>; 
 };
 
+//hands out slots of one size fixed at construction, bigger requests fail
+template<typename T>
+concept FixedSlotPoolLike = PoolLike<T> && requires(T& p, void* ptr) {
+	{p.free_count() } -> std::convertible_to<std::size_t>;
+	p.deallocate(ptr);
+};
+
 } // namespace engine::mem
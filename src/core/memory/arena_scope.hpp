@@ -0,0 +1,34 @@
+#pragma once
+
+#include<cstddef>
+
+#include"allocator_utils.hpp"
+
+namespace engine::mem::allocator{
+
+// rolls the arena back to where it was when the scope opened
+//	scopes must nest, anything allocated inside is gone on exit
+template<utils::MarkerArenaLike Arena>
+class ArenaScope{
+public:
+	explicit ArenaScope(Arena& arena) noexcept
+		: arena_(arena), marker_(arena.get_marker()){}
+	~ArenaScope() noexcept {arena_.rollback(marker_);}
+
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope& operator=(const ArenaScope&) = delete;
+
+	[[nodiscard]] void* allocate(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t)) noexcept{
+		return arena_.allocate(size, alignment);
+	}
+
+	[[nodiscard]] Arena& arena() noexcept {return arena_;}
+
+private:
+	Arena& arena_;
+	typename Arena::Marker marker_;
+};
+
+} // namespace engine::mem::allocator
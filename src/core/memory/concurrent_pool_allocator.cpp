@@ -0,0 +1,125 @@
+#include<cassert>
+#include<algorithm>
+
+#include"concurrent_pool_allocator.hpp"
+#include"page_allocator.hpp"
+#include"allocator_utils.hpp"
+
+namespace engine::mem::allocator{
+
+ConcurrentPoolAllocator::ConcurrentPoolAllocator(
+			PageAllocator& backing,
+			const std::size_t elem_size,
+			const std::size_t count,
+			std::size_t alignment)
+		: elem_size_(std::max(elem_size, sizeof(std::uint32_t))),
+		capacity_count_(count),
+		backing_allocator_(&backing){
+	assert(alignment >= alignof(std::uint32_t) &&
+		"alignment must be at least index size");
+	assert(count > 0 && count < kNullIndex && "pool count out of range");
+
+	stride_ = utils::align_up(elem_size_, alignment);
+	total_bytes_ = stride_ * count;
+	memory_ = static_cast<std::byte*>(
+		backing.allocate(total_bytes_, alignment)
+	);
+
+	assert(memory_ && "failed to allocate pool memory");
+
+	init_free_list();
+}
+
+ConcurrentPoolAllocator::~ConcurrentPoolAllocator() noexcept{
+	if(backing_allocator_ && memory_){
+		backing_allocator_->deallocate(memory_, total_bytes_);
+	}
+}
+
+void ConcurrentPoolAllocator::init_free_list() noexcept{
+	if(!memory_) return;
+
+	const auto count = static_cast<std::uint32_t>(capacity_count_);
+	for(std::uint32_t i = 0; i < count - 1; ++i){
+		next_of(i) = i + 1;
+	}
+	next_of(count - 1) = kNullIndex;
+
+	const std::uint32_t tag = tag_of(head_.load(std::memory_order_relaxed));
+	head_.store(pack(0, tag + 1), std::memory_order_release);
+	free_count_.store(capacity_count_, std::memory_order_relaxed);
+}
+
+void* ConcurrentPoolAllocator::allocate(
+		const std::size_t size,
+		const std::size_t align){
+	(void)align;
+
+	assert(size <= elem_size_ && "object too large for this pool");
+
+	std::uint64_t head = head_.load(std::memory_order_acquire);
+	for(;;){
+		const std::uint32_t index = index_of(head);
+		if(index == kNullIndex){
+			failed_allocs_.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		// the slot may be handed out by another thread right now,
+		// a torn read here is harmless because the tag makes the CAS fail
+		const std::uint32_t next = std::atomic_ref<std::uint32_t>(
+			next_of(index)).load(std::memory_order_relaxed);
+
+		if(head_.compare_exchange_weak(head, pack(next, tag_of(head) + 1),
+					std::memory_order_acquire,
+					std::memory_order_acquire)){
+			// counters trail the stack by a few instructions, clamp
+			// so a racing sampler never sees more than capacity
+			const std::size_t live = std::min(capacity_count_, capacity_count_ + 1
+				- free_count_.fetch_sub(1, std::memory_order_relaxed));
+			std::size_t peak = high_water_.load(std::memory_order_relaxed);
+			while(live > peak && !high_water_.compare_exchange_weak(
+						peak, live, std::memory_order_relaxed)){}
+
+			return utils::ptr_add<void>(memory_, index * stride_);
+		}
+	}
+}
+
+void ConcurrentPoolAllocator::deallocate(void* p) noexcept{
+	if(!p) return;
+
+	const std::size_t offset = utils::ptr_diff<std::byte>(p, memory_);
+	assert(offset < total_bytes_ && offset % stride_ == 0 
+		&& "pointer does not belong to this pool");
+	const auto index = static_cast<std::uint32_t>(offset / stride_);
+
+	std::uint64_t head = head_.load(std::memory_order_relaxed);
+	for(;;){
+		std::atomic_ref<std::uint32_t>(next_of(index)).store(
+			index_of(head), std::memory_order_relaxed);
+
+		if(head_.compare_exchange_weak(head, pack(index, tag_of(head) + 1),
+					std::memory_order_release,
+					std::memory_order_relaxed)){
+			free_count_.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+}
+
+void ConcurrentPoolAllocator::reset() noexcept{
+	init_free_list();
+}
+
+PoolStats ConcurrentPoolAllocator::stats() const noexcept{
+	PoolStats s;
+	s.capacity = capacity_count_;
+	s.free = free_count();
+	s.live = s.capacity - s.free;
+	s.high_water = high_water_.load(std::memory_order_relaxed);
+	s.failed_allocs = failed_allocs_.load(std::memory_order_relaxed);
+	return s;
+}
+
+}// namespace engine::mem::allocator
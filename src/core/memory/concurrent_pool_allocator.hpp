@@ -0,0 +1,82 @@
+#pragma once
+
+#include<algorithm>
+#include<atomic>
+#include<cstddef>
+#include<cstdint>
+
+#include"allocator_utils.hpp"
+#include"allocator_stats.hpp"
+#include"page_allocator.hpp"
+
+namespace engine::mem::allocator{
+
+// fixed size pool that can be allocated from and freed to by any thread
+//	free slots form a Treiber stack of slot indices, the head packs
+//	the index with a version tag so a stale CAS (ABA) always fails
+class ConcurrentPoolAllocator{
+public:
+	ConcurrentPoolAllocator(PageAllocator& backing,
+				const std::size_t elem_size,
+				const std::size_t count,
+				std::size_t alignment = alignof(std::max_align_t));
+
+	~ConcurrentPoolAllocator() noexcept;
+	ConcurrentPoolAllocator(const ConcurrentPoolAllocator&) = delete;
+
+	[[nodiscard]] void* allocate(const std::size_t size, const std::size_t align);
+	void deallocate(void* p) noexcept;
+
+	//not thread safe, no other thread may use the pool meanwhile
+	void reset() noexcept;
+
+	[[nodiscard]] std::size_t capacity() const noexcept {return capacity_count_;}
+	//the counter trails the stack, a racing pop can take it below zero
+	//	and a racing push past capacity, both are clamped
+	[[nodiscard]] std::size_t free_count() const noexcept{
+		const auto free = static_cast<std::ptrdiff_t>(
+			free_count_.load(std::memory_order_relaxed));
+		if(free < 0) return 0;
+		return std::min(capacity_count_, static_cast<std::size_t>(free));
+	}
+
+	[[nodiscard]] PoolStats stats() const noexcept;
+
+private:
+	static constexpr std::uint32_t kNullIndex = 0xFFFFFFFFu;
+
+	static std::uint64_t pack(std::uint32_t index, std::uint32_t tag) noexcept{
+		return (static_cast<std::uint64_t>(tag) << 32) | index;
+	}
+	static std::uint32_t index_of(std::uint64_t head) noexcept{
+		return static_cast<std::uint32_t>(head);
+	}
+	static std::uint32_t tag_of(std::uint64_t head) noexcept{
+		return static_cast<std::uint32_t>(head >> 32);
+	}
+
+	std::uint32_t& next_of(std::uint32_t index) const noexcept{
+		return *utils::ptr_add<std::uint32_t>(memory_, index * stride_);
+	}
+
+	void init_free_list() noexcept;
+
+	std::byte* memory_ = nullptr;
+
+	std::size_t elem_size_ = 0;
+	std::size_t stride_ = 0;
+	std::size_t capacity_count_ = 0;
+	std::size_t total_bytes_ = 0;
+
+	PageAllocator* backing_allocator_ = nullptr;
+
+	// keep the hot atomics on separate cache lines
+	alignas(64) std::atomic<std::uint64_t> head_ = 0;
+	alignas(64) std::atomic<std::size_t> free_count_ = 0;
+	std::atomic<std::size_t> high_water_ = 0;
+	std::atomic<std::size_t> failed_allocs_ = 0;
+};
+static_assert(utils::PoolLike<ConcurrentPoolAllocator>);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+} // namespace engine::mem::allocator
@@ -15,6 +15,7 @@ void* DefaultHeap::allocate(
 }
 
 void DefaultHeap::deallocate(void* p) noexcept{
+	if(p) --allocs_;
 	engine::mem::os::VirtualMemory::os_aligned_free(p);
 }
 
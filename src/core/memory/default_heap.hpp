@@ -7,6 +7,7 @@
 namespace engine::mem::allocator{
 
 struct DefaultHeap{
+	//blocks currently live
 	std::size_t allocs_ = 0;
 
 	DefaultHeap() noexcept = default;
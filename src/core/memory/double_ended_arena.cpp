@@ -0,0 +1,103 @@
+#include<cassert>
+#include<cstdint>
+
+#include"double_ended_arena.hpp"
+#include"page_allocator.hpp"
+
+namespace engine::mem::allocator{
+
+DoubleEndedArena::DoubleEndedArena(void* external_buffer, const std::size_t bytes) noexcept
+	: buffer_(static_cast<std::byte*>(external_buffer)),
+	capacity_(bytes),
+	backing_allocator_(nullptr){}
+
+DoubleEndedArena::DoubleEndedArena(PageAllocator& backing, const std::size_t bytes) noexcept
+		: capacity_(bytes), backing_allocator_(&backing){
+	buffer_ = static_cast<std::byte*>(backing.allocate(bytes, 16));
+	assert(buffer_
+			&& "failed to allocate memory for DoubleEndedArena from PageAllocator");
+}
+
+DoubleEndedArena::~DoubleEndedArena() noexcept{
+	if(backing_allocator_ && buffer_){
+		backing_allocator_->deallocate(buffer_, capacity_);
+	}
+}
+
+void* DoubleEndedArena::allocate_bottom(
+			const std::size_t size,
+			const std::size_t alignment) noexcept{
+	if(!buffer_) return nullptr;
+
+	const std::uintptr_t base_addr = reinterpret_cast<std::uintptr_t>(buffer_);
+	const std::size_t bottom = bottom_.load();
+	const std::uintptr_t aligned_addr = utils::align_up(base_addr + bottom, alignment);
+
+	const std::size_t new_bottom = aligned_addr - base_addr + size;
+	if(new_bottom > capacity_ - top_.load()){
+		return nullptr;
+	}
+
+	bottom_.store(new_bottom);
+	peak_.raise_to(new_bottom + top_.load());
+	return reinterpret_cast<void*>(aligned_addr);
+}
+
+void* DoubleEndedArena::allocate_top(
+			const std::size_t size,
+			const std::size_t alignment) noexcept{
+	if(!buffer_) return nullptr;
+
+	const std::uintptr_t base_addr = reinterpret_cast<std::uintptr_t>(buffer_);
+	const std::uintptr_t end_addr = base_addr + capacity_;
+	const std::size_t top = top_.load();
+
+	// the ends meet once the aligned start would dip below the bottom
+	if(size > capacity_ - top) return nullptr;
+	const std::uintptr_t aligned_addr = (end_addr - top - size) & ~(alignment - 1);
+	if(aligned_addr < base_addr + bottom_.load()){
+		return nullptr;
+	}
+
+	const std::size_t new_top = end_addr - aligned_addr;
+	top_.store(new_top);
+	peak_.raise_to(bottom_.load() + new_top);
+	return reinterpret_cast<void*>(aligned_addr);
+}
+
+void DoubleEndedArena::reset() noexcept{
+	bottom_.store(0);
+	top_.store(0);
+	resets_.add();
+}
+
+void DoubleEndedArena::reset_bottom() noexcept{
+	bottom_.store(0);
+	resets_.add();
+}
+
+void DoubleEndedArena::reset_top() noexcept{
+	top_.store(0);
+	resets_.add();
+}
+
+void DoubleEndedArena::rollback(const Marker marker) noexcept{
+	assert(marker <= bottom_.load() && "marker is newer than the bottom");
+	bottom_.store(marker);
+}
+
+void DoubleEndedArena::rollback_top(const Marker marker) noexcept{
+	assert(marker <= top_.load() && "marker is newer than the top");
+	top_.store(marker);
+}
+
+ArenaStats DoubleEndedArena::stats() const noexcept{
+	ArenaStats s;
+	s.capacity = capacity_;
+	s.in_use = in_use();
+	s.peak = peak_.load();
+	s.resets = resets_.load();
+	return s;
+}
+
+}// namespace engine::mem::allocator
@@ -0,0 +1,67 @@
+#pragma once
+
+#include"allocator_utils.hpp"
+#include"allocator_stats.hpp"
+#include"page_allocator.hpp"
+
+namespace engine::mem::allocator{
+
+// one block bumped from both ends, bottom grows up and top grows down
+//	allocate() serves the bottom so the arena works as a plain ArenaLike,
+//	out of memory is reported once the two ends would meet
+class DoubleEndedArena{
+public:
+	//bytes taken from the end the marker belongs to
+	using Marker = std::size_t;
+
+	DoubleEndedArena(void* external_buffer, const std::size_t bytes) noexcept;
+	explicit DoubleEndedArena(PageAllocator& backing, const std::size_t bytes) noexcept;
+	~DoubleEndedArena() noexcept;
+
+	DoubleEndedArena(const DoubleEndedArena&) = delete;
+	DoubleEndedArena& operator=(const DoubleEndedArena&) = delete;
+
+	[[nodiscard]] void* allocate(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t)) noexcept{
+		return allocate_bottom(size, alignment);
+	}
+	[[nodiscard]] void* allocate_bottom(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t)) noexcept;
+	[[nodiscard]] void* allocate_top(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t)) noexcept;
+
+	//clears both ends, each end reset counts as one reset in stats()
+	void reset() noexcept;
+	void reset_bottom() noexcept;
+	void reset_top() noexcept;
+
+	//bottom markers, so ArenaScope works on the bottom end
+	[[nodiscard]] Marker get_marker() const noexcept {return bottom_.load();}
+	void rollback(const Marker marker) noexcept;
+	[[nodiscard]] Marker get_top_marker() const noexcept {return top_.load();}
+	void rollback_top(const Marker marker) noexcept;
+
+	[[nodiscard]] std::size_t in_use() const {return bottom_.load() + top_.load();}
+	[[nodiscard]] std::size_t bottom_in_use() const {return bottom_.load();}
+	[[nodiscard]] std::size_t top_in_use() const {return top_.load();}
+	[[nodiscard]] std::size_t capacity() const {return capacity_;}
+
+	//safe to sample from any thread
+	[[nodiscard]] ArenaStats stats() const noexcept;
+
+private:
+	std::byte* buffer_ = nullptr;
+	std::size_t capacity_ = 0;
+	RelaxedCounter bottom_;
+	RelaxedCounter top_;
+	RelaxedCounter peak_;
+	RelaxedCounter resets_;
+
+	PageAllocator* backing_allocator_ = nullptr;
+};
+static_assert(utils::MarkerArenaLike<DoubleEndedArena>);
+
+} // namespace engine::mem::allocator
@@ -0,0 +1,59 @@
+#include<new>
+#include<utility>
+
+#include"fiber_stack.hpp"
+#include"allocator_utils.hpp"
+#include"virtual_memory.hpp"
+
+namespace engine::mem::allocator{
+
+using engine::mem::os::VirtualMemory;
+
+FiberStack::FiberStack(std::size_t stack_bytes, std::size_t guard_pages){
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	size_ = utils::align_up(stack_bytes ? stack_bytes : 1, page_size);
+	guard_bytes_ = guard_pages * page_size;
+
+	// the guard is never committed, a reserved page already faults
+	reserved_ = static_cast<std::byte*>(VirtualMemory::reserve(guard_bytes_ + size_));
+	if(!reserved_){
+		throw std::bad_alloc();
+	}
+	usable_ = reserved_ + guard_bytes_;
+	if(!VirtualMemory::commit(usable_, size_)){
+		VirtualMemory::release(reserved_, guard_bytes_ + size_);
+		throw std::bad_alloc();
+	}
+}
+
+FiberStack::~FiberStack() noexcept{
+	release();
+}
+
+FiberStack::FiberStack(FiberStack&& other) noexcept
+		: reserved_(std::exchange(other.reserved_, nullptr)),
+		usable_(std::exchange(other.usable_, nullptr)),
+		size_(std::exchange(other.size_, 0)),
+		guard_bytes_(std::exchange(other.guard_bytes_, 0)){}
+
+FiberStack& FiberStack::operator=(FiberStack&& other) noexcept{
+	if(this != &other){
+		release();
+		reserved_ = std::exchange(other.reserved_, nullptr);
+		usable_ = std::exchange(other.usable_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		guard_bytes_ = std::exchange(other.guard_bytes_, 0);
+	}
+	return *this;
+}
+
+void FiberStack::release() noexcept{
+	if(reserved_){
+		VirtualMemory::release(reserved_, guard_bytes_ + size_);
+		reserved_ = nullptr;
+		usable_ = nullptr;
+		size_ = 0;
+	}
+}
+
+} // namespace engine::mem::allocator
@@ -0,0 +1,40 @@
+#pragma once
+
+#include<cstddef>
+
+namespace engine::mem::allocator{
+
+// stack memory for a fiber or coroutine in its own reservation, the
+//	stack grows down so guard pages sit below the usable range and an
+//	overflow faults instead of running into a neighbour
+//	pages are committed up front but take RAM only once touched
+class FiberStack{
+public:
+	//throws std::bad_alloc when the range cant be reserved or committed
+	explicit FiberStack(std::size_t stack_bytes, std::size_t guard_pages = 1);
+	~FiberStack() noexcept;
+
+	FiberStack(const FiberStack&) = delete;
+	FiberStack& operator=(const FiberStack&) = delete;
+
+	FiberStack(FiberStack&& other) noexcept;
+	FiberStack& operator=(FiberStack&& other) noexcept;
+
+	//lowest usable byte, right above the guard
+	[[nodiscard]] void* base() const noexcept {return usable_;}
+	//one past the highest usable byte, the initial stack pointer
+	[[nodiscard]] void* top() const noexcept {return usable_ + size_;}
+	//usable bytes, rounded up to pages
+	[[nodiscard]] std::size_t size() const noexcept {return size_;}
+	[[nodiscard]] std::size_t guard_bytes() const noexcept {return guard_bytes_;}
+
+private:
+	void release() noexcept;
+
+	std::byte* reserved_ = nullptr;
+	std::byte* usable_ = nullptr;
+	std::size_t size_ = 0;
+	std::size_t guard_bytes_ = 0;
+};
+
+} // namespace engine::mem::allocator
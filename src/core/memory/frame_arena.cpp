@@ -0,0 +1,80 @@
+#include<algorithm>
+#include<cassert>
+
+#include"frame_arena.hpp"
+#include"virtual_memory.hpp"
+
+namespace engine::mem::allocator{
+
+using engine::mem::os::VirtualMemory;
+
+FrameArena::FrameArena(PageAllocator& backing,
+		const std::size_t bytes_per_frame,
+		const std::size_t frames_in_flight,
+		bool purge_tail)
+		: page_size_(backing.page_size()),
+		purge_tail_(purge_tail),
+		backing_allocator_(&backing){
+	assert(frames_in_flight >= 1 && "FrameArena needs at least one frame");
+
+	// whole pages per frame so a tail can be purged without touching neighbours
+	bytes_per_frame_ = utils::align_up(bytes_per_frame, page_size_);
+	memory_bytes_ = bytes_per_frame_ * frames_in_flight;
+	memory_ = static_cast<std::byte*>(backing.allocate(memory_bytes_, page_size_));
+	assert(memory_ && "failed to allocate memory for FrameArena from PageAllocator");
+
+	arenas_.reserve(frames_in_flight);
+	for(std::size_t i = 0; i < frames_in_flight; ++i){
+		arenas_.emplace_back(
+			memory_ ? memory_ + i * bytes_per_frame_ : nullptr,
+			memory_ ? bytes_per_frame_ : 0);
+	}
+	touched_.assign(frames_in_flight, 0);
+}
+
+FrameArena::~FrameArena() noexcept{
+	if(backing_allocator_ && memory_){
+		backing_allocator_->deallocate(memory_, memory_bytes_);
+	}
+}
+
+LinearArena& FrameArena::previous(std::size_t frames_ago) noexcept{
+	assert(frames_ago < arenas_.size() && "frame already retired");
+	const std::size_t n = arenas_.size();
+	return arenas_[(current_ + n - frames_ago % n) % n];
+}
+
+void FrameArena::begin_frame() noexcept{
+	usage_[frame_ % kUsageWindow] = arenas_[current_].in_use();
+
+	++frame_;
+	current_ = frame_ % arenas_.size();
+	retire(current_);
+}
+
+void FrameArena::retire(std::size_t index) noexcept{
+	LinearArena& arena = arenas_[index];
+	touched_[index] = std::max(touched_[index], arena.in_use());
+	arena.reset();
+
+	if(!purge_tail_ || !memory_) return;
+
+	const std::size_t high_water = utils::align_up(
+		*std::max_element(std::begin(usage_), std::end(usage_)), page_size_);
+	if(touched_[index] <= high_water) return;
+
+	const std::size_t touched = utils::align_up(touched_[index], page_size_);
+	VirtualMemory::purge(memory_ + index * bytes_per_frame_ + high_water,
+		touched - high_water);
+	purged_bytes_.add(touched - high_water);
+	touched_[index] = high_water;
+}
+
+void FrameArena::reset() noexcept{
+	for(std::size_t i = 0; i < arenas_.size(); ++i) retire(i);
+	current_ = 0;
+	frame_ = 0;
+	std::fill(std::begin(usage_), std::end(usage_), 0);
+}
+
+} // namespace engine::mem::allocator
@@ -0,0 +1,76 @@
+#pragma once
+
+#include<vector>
+
+#include"allocator_utils.hpp"
+#include"allocator_stats.hpp"
+#include"linear_arena.hpp"
+#include"page_allocator.hpp"
+
+namespace engine::mem::allocator{
+
+// N linear arenas carved from one PageAllocator block, one per frame in flight
+//	begin_frame() moves to the next arena and resets it, the data of
+//	the previous N-1 frames stays valid for the render/sim overlap
+//	with purge_tail the pages a retired arena touched above the recent
+//	high-water mark are handed back to the OS (the range stays usable)
+class FrameArena{
+public:
+	FrameArena(PageAllocator& backing,
+			const std::size_t bytes_per_frame,
+			const std::size_t frames_in_flight = 2,
+			bool purge_tail = false);
+	~FrameArena() noexcept;
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	//retires the oldest frame and makes its arena current
+	void begin_frame() noexcept;
+
+	[[nodiscard]] void* allocate(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t)) noexcept{
+		return arenas_[current_].allocate(size, alignment);
+	}
+	//drops every frame
+	void reset() noexcept;
+
+	[[nodiscard]] LinearArena& current() noexcept {return arenas_[current_];}
+	//arena of the frame frames_ago before the current one
+	[[nodiscard]] LinearArena& previous(std::size_t frames_ago = 1) noexcept;
+
+	[[nodiscard]] std::size_t frame_index() const noexcept {return frame_;}
+	[[nodiscard]] std::size_t frames_in_flight() const noexcept {return arenas_.size();}
+	[[nodiscard]] std::size_t capacity() const noexcept {return bytes_per_frame_;}
+	[[nodiscard]] std::size_t in_use() const noexcept {return arenas_[current_].in_use();}
+	[[nodiscard]] std::size_t purged_bytes() const noexcept {return purged_bytes_.load();}
+
+	//current frame, safe to sample from any thread
+	[[nodiscard]] ArenaStats stats() const noexcept {return arenas_[current_].stats();}
+
+private:
+	//frames the high-water mark looks back over
+	static constexpr std::size_t kUsageWindow = 16;
+
+	void retire(std::size_t index) noexcept;
+
+	std::vector<LinearArena> arenas_;
+	//bytes each arena has touched since its last purge
+	std::vector<std::size_t> touched_;
+	std::size_t usage_[kUsageWindow] = {};
+
+	std::size_t current_ = 0;
+	std::size_t frame_ = 0;
+	std::size_t bytes_per_frame_ = 0;
+	std::size_t page_size_ = 0;
+	bool purge_tail_ = false;
+	RelaxedCounter purged_bytes_;
+
+	std::byte* memory_ = nullptr;
+	std::size_t memory_bytes_ = 0;
+	PageAllocator* backing_allocator_ = nullptr;
+};
+static_assert(utils::ArenaLike<FrameArena>);
+
+} // namespace engine::mem::allocator
@@ -0,0 +1,212 @@
+#include<cassert>
+#include<algorithm>
+#include<new>
+
+#include"growing_pool_allocator.hpp"
+#include"page_allocator.hpp"
+#include"allocator_utils.hpp"
+
+namespace engine::mem::allocator{
+
+GrowingPoolAllocator::GrowingPoolAllocator(
+			PageAllocator& backing,
+			const std::size_t elem_size,
+			const std::size_t block_bytes,
+			std::size_t alignment,
+			bool release_empty_blocks)
+		: elem_size_(std::max(elem_size, sizeof(void*))),
+		release_empty_blocks_(release_empty_blocks),
+		backing_allocator_(&backing){
+	assert(alignment >= alignof(void*) &&
+		"alignment must be at least pointer size");
+	assert((block_bytes & (block_bytes - 1)) == 0 &&
+		"block size must be a power of two");
+
+	const std::size_t page_size = backing.page_size();
+	block_bytes_ = std::max(block_bytes, page_size);
+	stride_ = utils::align_up(elem_size_, alignment);
+	first_slot_offset_ = utils::align_up(sizeof(Block), alignment);
+	slots_per_block_ = block_bytes_ > first_slot_offset_
+		? (block_bytes_ - first_slot_offset_) / stride_
+		: 0;
+	//the page holding the header is never released
+	release_offset_ = utils::align_up(sizeof(Block), page_size);
+
+	assert(slots_per_block_ > 0 && "block too small for a single element");
+}
+
+GrowingPoolAllocator::~GrowingPoolAllocator() noexcept{
+	// the backing allocator assumes its pages are still committed
+	while(released_head_){
+		Block* b = released_head_;
+		released_head_ = b->next_partial;
+		(void)reacquire_block(b);
+	}
+
+	// newest first, so a LIFO backing gets its space back, a block that
+	//	could not be recommitted stays with the backing until its reset
+	Block* b = all_blocks_;
+	while(b){
+		Block* next = b->next_all;
+		if(!b->released) backing_allocator_->deallocate(b, block_bytes_);
+		b = next;
+	}
+}
+
+GrowingPoolAllocator::Block* GrowingPoolAllocator::grow() noexcept{
+	void* mem = backing_allocator_->allocate(block_bytes_, block_bytes_);
+	if(!mem) return nullptr;
+
+	Block* b = new (mem) Block{};
+	b->owner = this;
+	b->next_all = all_blocks_;
+	all_blocks_ = b;
+	++block_count_;
+	++empty_committed_;
+
+	push_partial(b);
+	return b;
+}
+
+void GrowingPoolAllocator::push_partial(Block* b) noexcept{
+	b->prev_partial = nullptr;
+	b->next_partial = partial_head_;
+	if(partial_head_) partial_head_->prev_partial = b;
+	partial_head_ = b;
+	b->in_partial = true;
+}
+
+void GrowingPoolAllocator::remove_partial(Block* b) noexcept{
+	if(b->prev_partial) b->prev_partial->next_partial = b->next_partial;
+	else partial_head_ = b->next_partial;
+	if(b->next_partial) b->next_partial->prev_partial = b->prev_partial;
+	b->prev_partial = nullptr;
+	b->next_partial = nullptr;
+	b->in_partial = false;
+}
+
+void GrowingPoolAllocator::release_block(Block* b) noexcept{
+	remove_partial(b);
+
+	if(block_bytes_ > release_offset_){
+		backing_allocator_->decommit_pages(
+			utils::ptr_add<void>(b, release_offset_),
+			block_bytes_ - release_offset_);
+	}
+	b->free_head = nullptr;
+	b->next_untouched = 0;
+
+	b->next_partial = released_head_;
+	b->released = true;
+	released_head_ = b;
+	++released_count_;
+	--empty_committed_;
+}
+
+bool GrowingPoolAllocator::reacquire_block(Block* b) noexcept{
+	if(block_bytes_ > release_offset_ && !backing_allocator_->recommit_pages(
+				utils::ptr_add<void>(b, release_offset_),
+				block_bytes_ - release_offset_)){
+		return false;
+	}
+	b->released = false;
+	--released_count_;
+	++empty_committed_;
+	return true;
+}
+
+void* GrowingPoolAllocator::allocate(
+		const std::size_t size,
+		const std::size_t align){
+	(void)align;
+
+	assert(size <= elem_size_ && "object too large for this pool");
+
+	Block* b = partial_head_;
+	if(!b && released_head_){
+		Block* r = released_head_;
+		if(reacquire_block(r)){
+			released_head_ = r->next_partial;
+			push_partial(r);
+			b = r;
+		}
+	}
+	if(!b) b = grow();
+	if(!b){
+		failed_allocs_.add();
+		return nullptr;
+	}
+
+	void* slot = nullptr;
+	if(b->free_head){
+		slot = b->free_head;
+		b->free_head = *static_cast<void**>(slot);
+	}
+	else{
+		slot = utils::ptr_add<void>(b,
+			first_slot_offset_ + b->next_untouched * stride_);
+		++b->next_untouched;
+	}
+
+	if(b->live++ == 0) --empty_committed_;
+	if(is_full(b)) remove_partial(b);
+
+	live_.add();
+	high_water_.raise_to(live_.load());
+	return slot;
+}
+
+void GrowingPoolAllocator::deallocate(void* p) noexcept{
+	if(!p) return;
+
+	Block* b = block_of(p);
+	*static_cast<void**>(p) = b->free_head;
+	b->free_head = p;
+	live_.sub();
+
+	if(!b->in_partial) push_partial(b);
+
+	if(--b->live == 0){
+		++empty_committed_;
+		if(release_empty_blocks_ && empty_committed_ > 1){
+			release_block(b);
+		}
+	}
+}
+
+void GrowingPoolAllocator::reset() noexcept{
+	partial_head_ = nullptr;
+	empty_committed_ = 0;
+
+	// released blocks stay released, the rest become fully free
+	for(Block* b = all_blocks_; b; b = b->next_all){
+		b->free_head = nullptr;
+		b->next_untouched = 0;
+		b->live = 0;
+		if(!b->released){
+			push_partial(b);
+			++empty_committed_;
+		}
+	}
+
+	live_.store(0);
+}
+
+GrowingPoolAllocator* GrowingPoolAllocator::owner_of(
+		void* p,
+		std::size_t block_bytes) noexcept{
+	auto addr = reinterpret_cast<std::uintptr_t>(p);
+	return reinterpret_cast<Block*>(addr & ~(block_bytes - 1))->owner;
+}
+
+PoolStats GrowingPoolAllocator::stats() const noexcept{
+	PoolStats s;
+	s.capacity = capacity();
+	s.live = live_.load();
+	s.free = s.capacity - s.live;
+	s.high_water = high_water_.load();
+	s.failed_allocs = failed_allocs_.load();
+	return s;
+}
+
+}// namespace engine::mem::allocator
@@ -0,0 +1,105 @@
+#pragma once
+
+#include"allocator_utils.hpp"
+#include"allocator_stats.hpp"
+#include"page_allocator.hpp"
+
+namespace engine::mem::allocator{
+
+// pool that grows in page aligned blocks pulled from its PageAllocator
+//	blocks are aligned to their own size, so the block (and its header)
+//	of any slot is found by masking the address, slots never move
+//	with release_empty_blocks the slot pages of empty blocks are
+//	decommitted through the backing, so its budget sees them go,
+//	one empty block is always kept warm to avoid thrashing
+class GrowingPoolAllocator{
+public:
+	GrowingPoolAllocator(PageAllocator& backing,
+				const std::size_t elem_size,
+				const std::size_t block_bytes = 64 * 1024,
+				std::size_t alignment = alignof(std::max_align_t),
+				bool release_empty_blocks = false);
+
+	~GrowingPoolAllocator() noexcept;
+	GrowingPoolAllocator(const GrowingPoolAllocator&) = delete;
+	GrowingPoolAllocator& operator=(const GrowingPoolAllocator&) = delete;
+
+	[[nodiscard]] void* allocate(const std::size_t size, const std::size_t align);
+	void deallocate(void* p) noexcept;
+	//forgets every slot, blocks are kept
+	void reset() noexcept;
+
+	//current capacity in slots, grows with the block count
+	[[nodiscard]] std::size_t capacity() const noexcept {
+		return block_count_ * slots_per_block_;
+	}
+	[[nodiscard]] std::size_t free_count() const noexcept {
+		return capacity() - live_.load();
+	}
+	[[nodiscard]] std::size_t block_count() const noexcept {return block_count_;}
+	[[nodiscard]] std::size_t released_block_count() const noexcept {
+		return released_count_;
+	}
+	[[nodiscard]] std::size_t slots_per_block() const noexcept {
+		return slots_per_block_;
+	}
+
+	[[nodiscard]] PoolStats stats() const noexcept;
+
+	//pool that handed out p, block_bytes must match its block size
+	[[nodiscard]] static GrowingPoolAllocator* owner_of(
+			void* p, std::size_t block_bytes) noexcept;
+
+private:
+	struct Block{
+		GrowingPoolAllocator* owner = nullptr;
+		Block* next_all = nullptr;
+		Block* prev_partial = nullptr;
+		Block* next_partial = nullptr;
+		void* free_head = nullptr;
+		std::size_t next_untouched = 0;
+		std::size_t live = 0;
+		bool in_partial = false;
+		bool released = false;
+	};
+
+	Block* grow() noexcept;
+	Block* block_of(void* p) const noexcept{
+		return reinterpret_cast<Block*>(
+			reinterpret_cast<std::uintptr_t>(p) & ~(block_bytes_ - 1));
+	}
+	bool is_full(const Block* b) const noexcept{
+		return !b->free_head && b->next_untouched == slots_per_block_;
+	}
+
+	void push_partial(Block* b) noexcept;
+	void remove_partial(Block* b) noexcept;
+	void release_block(Block* b) noexcept;
+	bool reacquire_block(Block* b) noexcept;
+
+	Block* all_blocks_ = nullptr;
+	Block* partial_head_ = nullptr;
+	//decommitted empty blocks, linked through next_partial
+	Block* released_head_ = nullptr;
+
+	std::size_t elem_size_ = 0;
+	std::size_t stride_ = 0;
+	std::size_t block_bytes_ = 0;
+	std::size_t first_slot_offset_ = 0;
+	std::size_t slots_per_block_ = 0;
+	std::size_t release_offset_ = 0;
+
+	std::size_t block_count_ = 0;
+	std::size_t released_count_ = 0;
+	std::size_t empty_committed_ = 0;
+	bool release_empty_blocks_ = false;
+
+	RelaxedCounter live_;
+	RelaxedCounter high_water_;
+	RelaxedCounter failed_allocs_;
+
+	PageAllocator* backing_allocator_ = nullptr;
+};
+static_assert(utils::PoolLike<GrowingPoolAllocator>);
+
+} // namespace engine::mem::allocator
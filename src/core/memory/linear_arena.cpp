@@ -20,6 +20,7 @@ LinearArena::LinearArena(PageAllocator& backing, const std::size_t bytes) noexce
 }
 
 LinearArena::~LinearArena() noexcept{
+	if(budget_) budget_->release(offset_.load());
 	if(backing_allocator_ && buffer_){
 		backing_allocator_->deallocate(buffer_, capacity_);
 	}
@@ -29,11 +30,15 @@ LinearArena::LinearArena(LinearArena&& other) noexcept
 		: buffer_(other.buffer_),
 		capacity_(other.capacity_),
 		offset_(other.offset_),
+		peak_(other.peak_),
+		resets_(other.resets_),
+		budget_(other.budget_),
 		backing_allocator_(other.backing_allocator_){
+	other.budget_ = nullptr;
 	other.backing_allocator_ = nullptr;
 	other.buffer_ = nullptr;
 	other.capacity_ = 0;
-	other.offset_ = 0;
+	other.offset_.store(0);
 }
 
 
@@ -43,7 +48,8 @@ void* LinearArena::allocate(
 	if(!buffer_) return nullptr;
 
 	std::uintptr_t base_addr = reinterpret_cast<std::uintptr_t>(buffer_);
-	std::uintptr_t current_addr = base_addr + offset_;
+	const std::size_t offset = offset_.load();
+	std::uintptr_t current_addr = base_addr + offset;
 
 	std::uintptr_t aligned_addr = (current_addr + alignment - 1)
 		& ~(alignment - 1);
@@ -51,14 +57,41 @@ void* LinearArena::allocate(
 	std::size_t padding = aligned_addr - current_addr;
 	std::size_t total_req = padding + size;
 
-	if(offset_ + total_req > capacity_){
+	if(offset + total_req > capacity_){
 		return nullptr;
 	}
 
-	offset_ += total_req;
+	offset_.store(offset + total_req);
+	peak_.raise_to(offset + total_req);
+	if(budget_) budget_->charge(total_req);
 	return reinterpret_cast<void*>(aligned_addr);
 }
 
-void LinearArena::reset() noexcept {offset_ = 0; }
+void LinearArena::reset() noexcept {
+	if(budget_) budget_->release(offset_.load());
+	offset_.store(0);
+	resets_.add();
+}
+
+void LinearArena::rollback(const Marker marker) noexcept{
+	assert(marker <= offset_.load() && "marker is newer than the arena top");
+	if(budget_) budget_->release(offset_.load() - marker);
+	offset_.store(marker);
+}
+
+void LinearArena::set_budget(MemoryBudget* budget) noexcept{
+	if(budget_) budget_->release(offset_.load());
+	budget_ = budget;
+	if(budget_) budget_->charge(offset_.load());
+}
+
+ArenaStats LinearArena::stats() const noexcept{
+	ArenaStats s;
+	s.capacity = capacity_;
+	s.in_use = offset_.load();
+	s.peak = peak_.load();
+	s.resets = resets_.load();
+	return s;
+}
 
 }// namespace engine::mem::allocator
@@ -1,12 +1,17 @@
 #pragma once
 
 #include"allocator_utils.hpp"
+#include"allocator_stats.hpp"
+#include"memory_budget.hpp"
 #include"page_allocator.hpp"
 
 namespace engine::mem::allocator{
 
 class LinearArena{
 public:
+	//offset to roll back to, only valid for the arena it came from
+	using Marker = std::size_t;
+
 	LinearArena(void* external_buffer, const std::size_t bytes) noexcept;
 	explicit LinearArena(PageAllocator& backing, const std::size_t bytes) noexcept;
 	~LinearArena() noexcept;
@@ -19,16 +24,30 @@ public:
 
 	[[nodiscard]] void* allocate(const std::size_t size, const std::size_t alignment = alignof(std::max_align_t)) noexcept;
 	void reset() noexcept;
-	[[nodiscard]] std::size_t in_use() const {return offset_;}
+
+	[[nodiscard]] Marker get_marker() const noexcept {return offset_.load();}
+	//frees everything allocated after the marker was taken
+	void rollback(const Marker marker) noexcept;
+
+	[[nodiscard]] std::size_t in_use() const {return offset_.load();}
 	[[nodiscard]] std::size_t capacity() const {return capacity_;}
 
+	//safe to sample from any thread
+	[[nodiscard]] ArenaStats stats() const noexcept;
+
+	//charges bytes in use to budget, nullptr detaches
+	void set_budget(MemoryBudget* budget) noexcept;
+
 private:
 	std::byte* buffer_ = nullptr;
 	std::size_t capacity_ = 0;
-	std::size_t offset_ = 0;
+	RelaxedCounter offset_;
+	RelaxedCounter peak_;
+	RelaxedCounter resets_;
 
+	MemoryBudget* budget_ = nullptr;
 	PageAllocator* backing_allocator_ = nullptr;
 };
-static_assert(utils::ArenaLike<LinearArena>);
+static_assert(utils::MarkerArenaLike<LinearArena>);
 
 } // namespace engine::mem::allocator
@@ -0,0 +1,50 @@
+#include<utility>
+
+#include"mapped_file.hpp"
+
+namespace engine::mem::os{
+
+MappedFile::MappedFile(const std::string& path, MapMode mode, AccessHint hint){
+	open(path, mode, hint);
+}
+
+MappedFile::~MappedFile() noexcept{
+	close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+		: data_(std::exchange(other.data_, nullptr)),
+		size_(std::exchange(other.size_, 0)),
+		mode_(other.mode_){}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept{
+	if(this != &other){
+		close();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		mode_ = other.mode_;
+	}
+	return *this;
+}
+
+bool MappedFile::open(const std::string& path, MapMode mode, AccessHint hint){
+	close();
+	data_ = static_cast<std::byte*>(VirtualMemory::map_file(path.c_str(), mode, size_));
+	mode_ = mode;
+	if(!data_) return false;
+
+	if(hint != AccessHint::Normal) advise(hint);
+	return true;
+}
+
+void MappedFile::close() noexcept{
+	VirtualMemory::unmap_file(data_, size_);
+	data_ = nullptr;
+	size_ = 0;
+}
+
+void MappedFile::advise(AccessHint hint){
+	VirtualMemory::advise(data_, size_, hint);
+}
+
+} // namespace engine::mem::os
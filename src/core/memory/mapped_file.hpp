@@ -0,0 +1,61 @@
+#pragma once
+
+#include<cstddef>
+#include<span>
+#include<string>
+#include<type_traits>
+
+#include"virtual_memory.hpp"
+
+namespace engine::mem::os{
+
+// owns a whole file mapping, assets are read in place with no copy
+//	a file that cant be opened or is empty leaves it closed
+class MappedFile{
+public:
+	MappedFile() noexcept = default;
+	explicit MappedFile(const std::string& path,
+			MapMode mode = MapMode::ReadOnly,
+			AccessHint hint = AccessHint::Normal);
+	~MappedFile() noexcept;
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	bool open(const std::string& path,
+			MapMode mode = MapMode::ReadOnly,
+			AccessHint hint = AccessHint::Normal);
+	void close() noexcept;
+
+	void advise(AccessHint hint);
+
+	[[nodiscard]] bool is_open() const noexcept {return data_ != nullptr;}
+	[[nodiscard]] MapMode mode() const noexcept {return mode_;}
+
+	[[nodiscard]] const std::byte* data() const noexcept {return data_;}
+	//writable only for CopyOnWrite mappings
+	[[nodiscard]] std::byte* mutable_data() noexcept{
+		return mode_ == MapMode::CopyOnWrite ? data_ : nullptr;
+	}
+	[[nodiscard]] std::size_t size() const noexcept {return size_;}
+
+	[[nodiscard]] std::span<const std::byte> bytes() const noexcept {return {data_, size_};}
+
+	//the file viewed as an array of T, a trailing partial element is cut
+	//	the mapping is page aligned so any T alignment holds at offset 0
+	template<typename T>
+	[[nodiscard]] std::span<const T> as() const noexcept{
+		static_assert(std::is_trivially_copyable_v<T>);
+		return {reinterpret_cast<const T*>(data_), size_ / sizeof(T)};
+	}
+
+private:
+	std::byte* data_ = nullptr;
+	std::size_t size_ = 0;
+	MapMode mode_ = MapMode::ReadOnly;
+};
+
+} // namespace engine::mem::os
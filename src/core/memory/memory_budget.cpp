@@ -0,0 +1,109 @@
+#include<mutex>
+
+#include"memory_budget.hpp"
+
+namespace engine::mem::allocator{
+
+namespace{
+
+// guards parent/child links of every tree
+std::mutex& tree_mutex(){
+	static std::mutex m;
+	return m;
+}
+
+} // namespace
+
+MemoryBudget::MemoryBudget(std::string name, MemoryBudget* parent, std::size_t budget)
+		: name_(std::move(name)), parent_(parent), budget_(budget){
+	if(!parent) return;
+
+	std::lock_guard<std::mutex> lock(tree_mutex());
+	next_sibling_ = parent->first_child_;
+	parent->first_child_ = this;
+}
+
+MemoryBudget::~MemoryBudget(){
+	std::lock_guard<std::mutex> lock(tree_mutex());
+
+	for(MemoryBudget* c = first_child_; c;){
+		MemoryBudget* next = c->next_sibling_;
+		c->parent_.store(nullptr, std::memory_order_release);
+		c->next_sibling_ = nullptr;
+		c = next;
+	}
+
+	MemoryBudget* parent = parent_.load(std::memory_order_relaxed);
+	if(!parent) return;
+
+	MemoryBudget** link = &parent->first_child_;
+	while(*link != this) link = &(*link)->next_sibling_;
+	*link = next_sibling_;
+
+	const std::size_t used = used_.load(std::memory_order_relaxed);
+	for(MemoryBudget* p = parent; p; p = p->parent()){
+		p->used_.fetch_sub(used, std::memory_order_relaxed);
+	}
+}
+
+void MemoryBudget::charge(std::size_t bytes) noexcept{
+	self_.fetch_add(bytes, std::memory_order_relaxed);
+	for(MemoryBudget* n = this; n; n = n->parent()) n->account(bytes);
+}
+
+void MemoryBudget::release(std::size_t bytes) noexcept{
+	self_.fetch_sub(bytes, std::memory_order_relaxed);
+	for(MemoryBudget* n = this; n; n = n->parent()){
+		n->used_.fetch_sub(bytes, std::memory_order_relaxed);
+	}
+}
+
+void MemoryBudget::account(std::size_t bytes) noexcept{
+	const std::size_t prev = used_.fetch_add(bytes, std::memory_order_relaxed);
+	const std::size_t now = prev + bytes;
+
+	std::size_t peak = peak_.load(std::memory_order_relaxed);
+	while(now > peak && !peak_.compare_exchange_weak(
+				peak, now, std::memory_order_relaxed)){}
+
+	// report the crossing only, not every charge above the line
+	const std::size_t budget = budget_.load(std::memory_order_relaxed);
+	if(budget != kUnlimited && prev <= budget && now > budget){
+		overruns_.fetch_add(1, std::memory_order_relaxed);
+		if(Callback cb = callback_.load(std::memory_order_relaxed)) cb(*this, now);
+	}
+}
+
+std::vector<BudgetNodeStats> MemoryBudget::snapshot() const{
+	std::vector<BudgetNodeStats> out;
+	std::lock_guard<std::mutex> lock(tree_mutex());
+	snapshot_into(out, 0);
+	return out;
+}
+
+void MemoryBudget::snapshot_into(std::vector<BudgetNodeStats>& out, std::size_t depth) const{
+	BudgetNodeStats s;
+	s.name = name_;
+	s.depth = depth;
+	s.used = used();
+	s.self = self_used();
+	s.peak = peak();
+	s.budget = budget();
+	s.overruns = overruns();
+	out.push_back(std::move(s));
+
+	for(const MemoryBudget* c = first_child_; c; c = c->next_sibling_){
+		c->snapshot_into(out, depth + 1);
+	}
+}
+
+void MemoryBudget::dump(std::FILE* out) const{
+	for(const BudgetNodeStats& s : snapshot()){
+		const int indent = static_cast<int>(s.depth * 2);
+		std::fprintf(out, "%*s%-*s used %zu peak %zu budget %zu overruns %zu\n",
+			indent, "", indent < 24 ? 24 - indent : 0, s.name.c_str(),
+			s.used, s.peak, s.budget, s.overruns);
+	}
+}
+
+} // namespace engine::mem::allocator
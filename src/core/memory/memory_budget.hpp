@@ -0,0 +1,87 @@
+#pragma once
+
+#include<atomic>
+#include<cstddef>
+#include<cstdio>
+#include<string>
+#include<vector>
+
+namespace engine::mem::allocator{
+
+class MemoryBudget;
+
+struct BudgetNodeStats{
+	std::string name;
+	//0 for the node the snapshot was taken from
+	std::size_t depth = 0;
+	//own bytes plus every descendant
+	std::size_t used = 0;
+	//bytes charged to this node directly
+	std::size_t self = 0;
+	std::size_t peak = 0;
+	std::size_t budget = 0;
+	std::size_t overruns = 0;
+};
+
+// node in the memory ownership tree, e.g. root > physics > broadphase
+//	allocators charge the node they are attached to, usage rolls up to
+//	every ancestor and crossing a node's budget calls its callback
+//	(the allocation itself still goes through)
+//	charging is lock-free, only tree changes and snapshots take a lock
+//	a charge walks the parent links without the lock, so a node may only
+//	be destroyed once nothing charges it or its subtree anymore
+class MemoryBudget{
+public:
+	using Callback = void(*)(const MemoryBudget& node, std::size_t used);
+	static constexpr std::size_t kUnlimited = 0;
+
+	explicit MemoryBudget(std::string name,
+			MemoryBudget* parent = nullptr,
+			std::size_t budget = kUnlimited);
+	//children become roots, usage is taken back from the ancestors
+	//	must not race charges to this node or its subtree
+	~MemoryBudget();
+
+	MemoryBudget(const MemoryBudget&) = delete;
+	MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+	void charge(std::size_t bytes) noexcept;
+	void release(std::size_t bytes) noexcept;
+
+	void set_budget(std::size_t bytes) noexcept {budget_.store(bytes, std::memory_order_relaxed);}
+	void set_callback(Callback callback) noexcept {callback_.store(callback, std::memory_order_relaxed);}
+
+	[[nodiscard]] const std::string& name() const noexcept {return name_;}
+	[[nodiscard]] MemoryBudget* parent() const noexcept {
+		return parent_.load(std::memory_order_acquire);
+	}
+	[[nodiscard]] std::size_t used() const noexcept {return used_.load(std::memory_order_relaxed);}
+	[[nodiscard]] std::size_t self_used() const noexcept {return self_.load(std::memory_order_relaxed);}
+	[[nodiscard]] std::size_t peak() const noexcept {return peak_.load(std::memory_order_relaxed);}
+	[[nodiscard]] std::size_t budget() const noexcept {return budget_.load(std::memory_order_relaxed);}
+	[[nodiscard]] std::size_t overruns() const noexcept {return overruns_.load(std::memory_order_relaxed);}
+
+	//this node and its subtree, depth first
+	[[nodiscard]] std::vector<BudgetNodeStats> snapshot() const;
+	//snapshot as an indented table
+	void dump(std::FILE* out = stdout) const;
+
+private:
+	void account(std::size_t bytes) noexcept;
+	void snapshot_into(std::vector<BudgetNodeStats>& out, std::size_t depth) const;
+
+	std::string name_;
+	//written under the tree lock, read without it by charge/release
+	std::atomic<MemoryBudget*> parent_ = nullptr;
+	MemoryBudget* first_child_ = nullptr;
+	MemoryBudget* next_sibling_ = nullptr;
+
+	std::atomic<std::size_t> self_ = 0;
+	std::atomic<std::size_t> used_ = 0;
+	std::atomic<std::size_t> peak_ = 0;
+	std::atomic<std::size_t> budget_ = kUnlimited;
+	std::atomic<std::size_t> overruns_ = 0;
+	std::atomic<Callback> callback_ = nullptr;
+};
+
+} // namespace engine::mem::allocator
@@ -0,0 +1,38 @@
+#pragma once
+
+#include<memory_resource>
+#include<new>
+
+#include"allocator_utils.hpp"
+
+namespace engine::mem::allocator{
+
+// std::pmr bridge over an AllocatorHandle or StaticAllocatorRef
+//	lets std::pmr containers draw from engine allocators, frees are
+//	dropped when the allocator cannot free (arenas)
+template<utils::HandleLike Handle>
+class HandleMemoryResource final : public std::pmr::memory_resource{
+public:
+	explicit HandleMemoryResource(Handle handle) noexcept : handle_(handle){}
+
+	[[nodiscard]] const Handle& handle() const noexcept {return handle_;}
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override{
+		void* p = handle_.allocate(bytes, alignment);
+		if(!p) throw std::bad_alloc();
+		return p;
+	}
+
+	void do_deallocate(void* p, std::size_t, std::size_t) override{
+		handle_.deallocate(p);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override{
+		return this == &other;
+	}
+
+	Handle handle_;
+};
+
+} // namespace engine::mem::allocator
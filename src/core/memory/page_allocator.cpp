@@ -1,5 +1,7 @@
 #include<stdexcept>
 #include<cassert>
+#include<iterator>
+#include<vector>
 
 #include"page_allocator.hpp"
 #include"virtual_memory.hpp"
@@ -8,91 +10,615 @@ namespace engine::mem::allocator{
 
 using engine::mem::os::VirtualMemory;
 
+namespace{
+
+std::atomic<std::uint64_t> g_next_epoch = 1;
+
+struct ThreadChunk{
+	std::uint64_t epoch = 0;
+	std::uintptr_t cursor = 0;
+	std::uintptr_t end = 0;
+};
+
+// a thread rarely works with more than a few page allocators at once,
+// older chunks are evicted round robin (their tail is reclaimed on reset)
+constexpr std::size_t kThreadChunkSlots = 4;
+thread_local ThreadChunk t_chunks[kThreadChunkSlots];
+thread_local std::size_t t_next_slot = 0;
+
+} // namespace
+
 void PageAllocator::init(std::size_t max_size_bytes){
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = max_size_bytes;
+	init(desc);
+}
+
+void PageAllocator::init(const PageAllocatorDesc& desc){
 	page_size_ = VirtualMemory::get_page_size();
+	page_backing_ = os::PageBacking::Regular;
 
-	reserved_size_ = utils::align_up(max_size_bytes, page_size_);
-	base_ptr_ = VirtualMemory::reserve(reserved_size_);
+	const std::size_t huge_size = desc.huge_pages
+		? VirtualMemory::get_huge_page_size()
+		: 0;
+	if(huge_size > page_size_){
+		reserved_size_ = utils::align_up(desc.max_size_bytes, huge_size);
+		base_ptr_ = VirtualMemory::reserve_huge(reserved_size_, page_backing_);
+		if(page_backing_ != os::PageBacking::Regular){
+			page_size_ = huge_size;
+		}
+	}
+	else{
+		reserved_size_ = utils::align_up(desc.max_size_bytes, page_size_);
+		base_ptr_ = VirtualMemory::reserve(reserved_size_);
+	}
 
 	if(!base_ptr_){
 		throw std::bad_alloc();
 	}
 
-	current_offset_ = 0;
-	committed_head_ = 0;
+	thread_chunk_bytes_ = desc.thread_chunk_bytes
+		? utils::align_up(desc.thread_chunk_bytes, page_size_)
+		: 0;
+	thread_request_limit_ = thread_chunk_bytes_ / 4;
+
+	numa_policy_ = VirtualMemory::numa_node_count() > 1
+		? desc.numa_policy
+		: os::NumaPolicy::FirstTouch;
+	numa_node_ = desc.numa_node;
+	decommit_freed_ = desc.decommit_freed;
+	worker_ = desc.worker;
+	reclaim_mode_ = desc.reclaim_mode;
+	commit_ahead_bytes_ = utils::align_up(desc.commit_ahead_bytes, page_size_);
+	prefault_ = desc.prefault;
+	guard_pages_ = desc.guard_pages;
+	// the leading guard is simply never committed
+	start_offset_ = guard_pages_ ? page_size_ : 0;
+	guard_offsets_.clear();
+	guard_bytes_.store(start_offset_);
+	free_by_offset_.clear();
+	free_by_size_.clear();
+	free_bytes_.store(0);
+	free_ranges_.store(0);
+	thread_chunks_.clear();
+	lent_holes_.clear();
+	decommitted_free_.store(0);
+
+	current_offset_ = start_offset_;
+	committed_head_ = start_offset_;
+	peak_committed_.store(0);
+	commit_calls_.store(0);
+	decommit_calls_.store(0);
+	prefaulted_.store(0);
+	epoch_ = g_next_epoch.fetch_add(1, std::memory_order_relaxed);
 }
 
 void* PageAllocator::allocate(std::size_t size, std::size_t alignment){
+	if(thread_chunk_bytes_ && size <= thread_request_limit_
+			&& alignment <= page_size_){
+		return allocate_thread_local(size, alignment);
+	}
+
 	std::lock_guard<std::mutex> lock(mutex_);
+	return allocate_locked(size, alignment);
+}
+
+void* PageAllocator::allocate_locked(std::size_t size, std::size_t alignment){
+	// whole pages, so every request can be freed back as a page run
+	size = utils::align_up(size, page_size_);
+	alignment = std::max(alignment, page_size_);
+	if(guard_pages_) size += page_size_;
+
+	std::size_t reused = 0;
+	if(!free_by_size_.empty() && take_free_range(size, alignment, reused)){
+		if(guard_pages_) add_guard(reused + size - page_size_);
+		return utils::ptr_add<void>(base_ptr_, reused);
+	}
 
 	std::size_t base_addr = reinterpret_cast<std::size_t>(
 		base_ptr_
 	);
 
-	std::size_t current_addr = base_addr + current_offset_;
-	std::size_t aligned_addr = utils::align_up(current_addr, alignment);
+	// thread chunks bump the offset without the lock, so CAS it anyway
+	std::size_t offset = current_offset_.load(std::memory_order_relaxed);
+	for(;;){
+		std::size_t current_addr = base_addr + offset;
+		std::size_t aligned_addr = utils::align_up(current_addr, alignment);
+
+		std::size_t padding = aligned_addr - current_addr;
+		std::size_t new_offset = offset + padding + size;
+
+		if(new_offset > reserved_size_)
+			return nullptr;
+
+		if(!commit_up_to_locked(new_offset))
+			return nullptr;
+
+		if(current_offset_.compare_exchange_weak(
+					offset, new_offset, std::memory_order_relaxed)){
+			if(guard_pages_) add_guard(new_offset - page_size_);
+			return reinterpret_cast<void*>(aligned_addr);
+		}
+	}
+}
+
+void PageAllocator::add_guard(std::size_t offset){
+	VirtualMemory::guard(utils::ptr_add<void>(base_ptr_, offset), page_size_);
+	guard_offsets_.insert(offset);
+	guard_bytes_.add(page_size_);
+	if(budget_) budget_->release(page_size_);
+}
+
+void PageAllocator::remove_guard(std::size_t offset){
+	if(!guard_offsets_.erase(offset)) return;
+	// a failed commit leaves the page out of reuse, the range stays safe
+	if(!VirtualMemory::commit(utils::ptr_add<void>(base_ptr_, offset), page_size_,
+				numa_policy_, numa_node_)){
+		guard_offsets_.insert(offset);
+		return;
+	}
+	guard_bytes_.sub(page_size_);
+	if(budget_) budget_->charge(page_size_);
+}
 
-	std::size_t padding = aligned_addr - current_addr;
-	std::size_t new_offset = current_offset_ + padding + size;
+void* PageAllocator::allocate_thread_local(
+		std::size_t size,
+		std::size_t alignment){
+	const std::uint64_t epoch = epoch_.load(std::memory_order_acquire);
 
-	if(new_offset > reserved_size_)
-		return nullptr;
+	ThreadChunk* chunk = nullptr;
+	for(auto& c : t_chunks){
+		if(c.epoch == epoch){
+			chunk = &c;
+			break;
+		}
+	}
 
-	if(new_offset > committed_head_){
-		std::size_t needed = new_offset - committed_head_;
-		std::size_t pages_needed = utils::align_up(needed, page_size_);
+	if(chunk){
+		std::uintptr_t aligned = utils::align_up(chunk->cursor, alignment);
+		if(aligned + size <= chunk->end){
+			chunk->cursor = aligned + size;
+			return reinterpret_cast<void*>(aligned);
+		}
+	}
+	else{
+		chunk = &t_chunks[t_next_slot++ % kThreadChunkSlots];
+	}
 
-		void* commit_ptr = utils::ptr_add<void>(base_ptr_, committed_head_);
+	// refill: carve a fresh chunk, only the commit and registering it
+	//	need the lock
+	std::size_t offset = 0;
+	if(!reserve_range(thread_chunk_bytes_, page_size_, offset)){
+		// range is almost exhausted, let the locked path squeeze it in
+		std::lock_guard<std::mutex> lock(mutex_);
+		return allocate_locked(size, alignment);
+	}
 
-		if(!VirtualMemory::commit(commit_ptr, pages_needed)){
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if(!commit_up_to_locked(offset + thread_chunk_bytes_)){
 			return nullptr;
 		}
+		// lets deallocate tell chunk memory from locked blocks
+		thread_chunks_.insert(offset);
+	}
+
+	std::uintptr_t start = reinterpret_cast<std::uintptr_t>(base_ptr_) + offset;
+	chunk->epoch = epoch;
+	chunk->cursor = start + size;
+	chunk->end = start + thread_chunk_bytes_;
+
+	return reinterpret_cast<void*>(start);
+}
 
-		committed_head_ += pages_needed;
+bool PageAllocator::reserve_range(
+		std::size_t size,
+		std::size_t alignment,
+		std::size_t& out_offset){
+	std::size_t offset = current_offset_.load(std::memory_order_relaxed);
+	for(;;){
+		std::size_t aligned = utils::align_up(offset, alignment);
+		std::size_t new_offset = aligned + size;
+
+		if(new_offset > reserved_size_)
+			return false;
+
+		if(current_offset_.compare_exchange_weak(
+					offset, new_offset, std::memory_order_relaxed)){
+			out_offset = aligned;
+			return true;
+		}
+	}
+}
+
+bool PageAllocator::commit_up_to_locked(std::size_t end_offset){
+	std::size_t head = committed_head_.load(std::memory_order_relaxed);
+	if(end_offset <= head) return true;
+
+	// a reset may still be decommitting the range above the head
+	if(!worker_jobs_.empty()){
+		wait_for_worker(head, reserved_size_ - head);
+		head = committed_head_.load(std::memory_order_relaxed);
+		if(end_offset <= head) return true;
 	}
 
-	void*result = reinterpret_cast<void*>(aligned_addr);
-	current_offset_ = new_offset;
+	std::size_t needed = end_offset - head;
+	std::size_t pages_needed = utils::align_up(needed, page_size_);
+	const std::size_t ahead = std::min(commit_ahead_bytes_,
+		reserved_size_ - head - pages_needed);
+
+	void* commit_ptr = utils::ptr_add<void>(base_ptr_, head);
 
-	return result;
+	if(!VirtualMemory::commit(commit_ptr, pages_needed + ahead, numa_policy_, numa_node_)){
+		// the window is a nicety, the request itself may still fit
+		if(ahead == 0 || !VirtualMemory::commit(commit_ptr, pages_needed,
+					numa_policy_, numa_node_)){
+			return false;
+		}
+	}
+	else{
+		pages_needed += ahead;
+	}
+
+	// before publishing the head, nobody else can see these pages yet
+	prefault_range(head, pages_needed);
+	committed_head_.store(head + pages_needed, std::memory_order_release);
+	if(budget_) budget_->charge(pages_needed);
+	commit_calls_.add();
+	peak_committed_.raise_to(committed_bytes());
+	return true;
 }
 
-void PageAllocator::deallocate(void*ptr, std::size_t size){
-	//LIFO
-	
-	std::lock_guard<std::mutex> lock(mutex_);
+bool PageAllocator::take_free_range(
+		std::size_t size,
+		std::size_t alignment,
+		std::size_t& out_offset){
+	const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(base_ptr_);
+
+	// smallest run that fits, only alignments above a page ever skip one
+	for(auto it = free_by_size_.lower_bound({size, 0});
+			it != free_by_size_.end(); ++it){
+		const auto [run_size, run_offset] = *it;
+		const std::size_t start = utils::align_up(base + run_offset, alignment) - base;
+		if(start + size > run_offset + run_size) continue;
+
+		// detach first, recommitting may wait on the worker unlocked
+		erase_free_range(free_by_offset_.find(run_offset));
+		if(start > run_offset) insert_free_range(run_offset, start - run_offset);
+		const std::size_t end = start + size;
+		if(end < run_offset + run_size){
+			insert_free_range(end, run_offset + run_size - end);
+		}
+
+		if(decommit_freed_ && !recommit_range(start, size)){
+			insert_free_range(start, size);
+			return false;
+		}
+		out_offset = start;
+		return true;
+	}
+	return false;
+}
+
+void PageAllocator::insert_free_range(std::size_t offset, std::size_t size){
+	auto next = free_by_offset_.lower_bound(offset);
+	if(next != free_by_offset_.end() && offset + size == next->first){
+		size += next->second;
+		erase_free_range(next);
+	}
+	auto next_after = free_by_offset_.lower_bound(offset);
+	if(next_after != free_by_offset_.begin()){
+		auto prev = std::prev(next_after);
+		if(prev->first + prev->second == offset){
+			offset = prev->first;
+			size += prev->second;
+			erase_free_range(prev);
+		}
+	}
+
+	free_by_offset_.emplace(offset, size);
+	free_by_size_.emplace(size, offset);
+	free_bytes_.add(size);
+	free_ranges_.add();
+}
+
+void PageAllocator::erase_free_range(
+		std::map<std::size_t, std::size_t>::iterator it){
+	free_by_size_.erase({it->second, it->first});
+	free_bytes_.sub(it->second);
+	free_ranges_.sub();
+	free_by_offset_.erase(it);
+}
+
+bool PageAllocator::recommit_range(std::size_t offset, std::size_t size){
+	wait_for_worker(offset, size);
+	if(!VirtualMemory::commit(utils::ptr_add<void>(base_ptr_, offset), size,
+				numa_policy_, numa_node_)){
+		return false;
+	}
+	prefault_range(offset, size);
+	decommitted_free_.sub(size);
+	if(budget_) budget_->charge(size);
+	commit_calls_.add();
+	peak_committed_.raise_to(committed_bytes());
+	return true;
+}
+
+void PageAllocator::decommit_range(std::size_t offset, std::size_t size){
+	reclaim_range(offset, size);
+	decommitted_free_.add(size);
+	if(budget_) budget_->release(size);
+}
+
+void PageAllocator::reclaim_range(std::size_t offset, std::size_t size){
+	void* ptr = utils::ptr_add<void>(base_ptr_, offset);
+	decommit_calls_.add();
+	if(!worker_){
+		VirtualMemory::reclaim(ptr, size, reclaim_mode_);
+		return;
+	}
+
+	PageWorker::Job job;
+	job.ptr = ptr;
+	job.size = size;
+	job.mode = reclaim_mode_;
+	submit_to_worker(job, offset);
+}
+
+void PageAllocator::prefault_range(std::size_t offset, std::size_t size){
+	if(prefault_ == os::PrefaultMode::None) return;
+	prefaulted_.add(size);
+
+	void* ptr = utils::ptr_add<void>(base_ptr_, offset);
+	if(!worker_ || prefault_ != os::PrefaultMode::Populate){
+		VirtualMemory::prefault(ptr, size, prefault_);
+		return;
+	}
 
+	PageWorker::Job job;
+	job.kind = PageWorker::Kind::Prefault;
+	job.ptr = ptr;
+	job.size = size;
+	submit_to_worker(job, offset);
+}
+
+void PageAllocator::submit_to_worker(PageWorker::Job job, std::size_t offset){
+	// tracked so shutdown can wait for it
+	worker_jobs_.emplace_back(offset, job.size);
+	job.done = &PageAllocator::on_worker_done;
+	job.context = this;
+	worker_->submit(job);
+}
+
+void PageAllocator::on_worker_done(void* context, void* ptr, std::size_t size){
+	auto* self = static_cast<PageAllocator*>(context);
+	std::lock_guard<std::mutex> lock(self->mutex_);
+	const std::size_t offset = static_cast<std::size_t>(
+		static_cast<std::byte*>(ptr) - static_cast<std::byte*>(self->base_ptr_));
+	auto it = std::find(self->worker_jobs_.begin(), self->worker_jobs_.end(),
+		std::make_pair(offset, size));
+	if(it != self->worker_jobs_.end()){
+		*it = self->worker_jobs_.back();
+		self->worker_jobs_.pop_back();
+	}
+	self->worker_cv_.notify_all();
+}
+
+void PageAllocator::wait_for_worker(std::size_t offset, std::size_t size){
+	// mutex_ is held by the caller, the wait drops it meanwhile
+	worker_cv_.wait(mutex_, [&]{
+		for(auto [o, s] : worker_jobs_){
+			if(o < offset + size && offset < o + s) return false;
+		}
+		return true;
+	});
+}
+
+void PageAllocator::deallocate(void*ptr, std::size_t size){
 	if(!ptr || size == 0) return;
 
+	std::lock_guard<std::mutex> lock(mutex_);
+
 	std::size_t addr = reinterpret_cast<std::size_t>(ptr);
 	std::size_t base = reinterpret_cast<std::size_t>(base_ptr_);
 
 	if(addr < base || addr >= base + reserved_size_) return;
 
-	std::size_t chunk_end_offset = (addr + size) - base;
-	if(chunk_end_offset == current_offset_){
-		current_offset_ = addr - base;
+	const std::size_t offset = addr - base;
+
+	// served from a thread chunk, reclaimed on reset
+	if(!thread_chunks_.empty()){
+		auto chunk = thread_chunks_.upper_bound(offset);
+		if(chunk != thread_chunks_.begin()
+				&& offset < *std::prev(chunk) + thread_chunk_bytes_){
+			return;
+		}
+	}
+	std::size_t extent = utils::align_up(size, page_size_);
+	if(guard_pages_){
+		extent += page_size_;
+		remove_guard(offset + extent - page_size_);
+	}
+
+	// topmost chunk, hand it back to the bump pointer
+	std::size_t end_offset = offset + extent;
+	if(current_offset_.compare_exchange_strong(
+				end_offset, offset, std::memory_order_relaxed)){
+		absorb_free_tail(offset);
+		return;
+	}
+
+	if(decommit_freed_) decommit_range(offset, extent);
+	insert_free_range(offset, extent);
+}
+
+void PageAllocator::absorb_free_tail(std::size_t top){
+	auto it = free_by_offset_.lower_bound(top);
+	if(it == free_by_offset_.begin()) return;
+	--it;
+	if(it->first + it->second != top) return;
+
+	// everything between the bump offset and committed_head_ counts as
+	//	committed for thread chunks, so recommit before lowering the offset
+	const std::size_t run_offset = it->first;
+	const std::size_t run_size = it->second;
+	erase_free_range(it);
+	if(decommit_freed_ && !recommit_range(run_offset, run_size)){
+		insert_free_range(run_offset, run_size);
+		return;
+	}
+
+	std::size_t expected = top;
+	if(!current_offset_.compare_exchange_strong(
+				expected, run_offset, std::memory_order_relaxed)){
+		if(decommit_freed_) decommit_range(run_offset, run_size);
+		insert_free_range(run_offset, run_size);
 	}
 }
 
 void PageAllocator::shutdown(){
 	if(base_ptr_){
+		// the worker must be done with the range before it is unmapped
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			worker_cv_.wait(mutex_, [this]{ return worker_jobs_.empty(); });
+		}
+		if(budget_) budget_->release(committed_bytes());
 		VirtualMemory::release(base_ptr_, reserved_size_);
 		base_ptr_ = nullptr;
 		reserved_size_ = 0;
 		committed_head_ = 0;
 		current_offset_ = 0;
+		guard_offsets_.clear();
+		guard_bytes_.store(0);
+		thread_chunks_.clear();
+		start_offset_ = 0;
+		guard_pages_ = false;
+		free_by_offset_.clear();
+		free_by_size_.clear();
+		free_bytes_.store(0);
+		free_ranges_.store(0);
+		lent_holes_.clear();
+		decommitted_free_.store(0);
+		page_backing_ = os::PageBacking::Regular;
+		numa_policy_ = os::NumaPolicy::FirstTouch;
+		thread_chunk_bytes_ = 0;
+		thread_request_limit_ = 0;
+		epoch_ = 0;
 	}
 }
 
 void PageAllocator::reset(bool decommit_unused){
 	std::lock_guard<std::mutex> lock(mutex_);
-	current_offset_ = 0;
 
-	if(decommit_unused && committed_head_ > 0){
-		VirtualMemory::decommit(base_ptr_, committed_head_);
-		committed_head_ = 0;
+	// the bump path treats everything below committed_head_ as
+	//	committed, fill the holes or give up the range above them
+	// recommitting can wait on the worker and drop the lock, so it runs
+	//	while the old offset still keeps the bump path off the holes and
+	//	frees landing meanwhile are picked up by the next pass
+	// pages lent out by decommit_pages are holes too, their blocks die
+	//	here, free runs only are when decommit_freed_ released them
+	while(!decommit_unused && decommitted_free_.load() > 0){
+		const bool runs = decommit_freed_ && !free_by_offset_.empty();
+		if(!runs && lent_holes_.empty()) break;
+		// lowest first, a failure gives up everything above it
+		const bool lent = !runs || (!lent_holes_.empty()
+			&& lent_holes_.begin()->first < free_by_offset_.begin()->first);
+		auto [offset, size] = lent ? *lent_holes_.begin() : *free_by_offset_.begin();
+		if(lent) lent_holes_.erase(lent_holes_.begin());
+		else erase_free_range(free_by_offset_.begin());
+		if(!recommit_range(offset, size)){
+			const std::size_t head = committed_head_.load(std::memory_order_relaxed);
+			if(budget_) budget_->release(committed_bytes());
+			reclaim_range(offset, head - offset);
+			committed_head_ = offset;
+			decommitted_free_.store(0);
+			for(auto it = guard_offsets_.lower_bound(offset); it != guard_offsets_.end();){
+				it = guard_offsets_.erase(it);
+				guard_bytes_.sub(page_size_);
+			}
+			if(budget_) budget_->charge(committed_bytes());
+			break;
+		}
+	}
+
+	// nothing below waits, so no allocation sees the new epoch early
+	current_offset_ = start_offset_;
+	epoch_.store(g_next_epoch.fetch_add(1, std::memory_order_relaxed),
+		std::memory_order_release);
+
+	std::size_t head = committed_head_.load(std::memory_order_relaxed);
+	free_by_offset_.clear();
+	free_by_size_.clear();
+	free_bytes_.store(0);
+	free_ranges_.store(0);
+	thread_chunks_.clear();
+	lent_holes_.clear();
+
+	if(decommit_unused && head > start_offset_){
+		if(budget_) budget_->release(committed_bytes());
+		reclaim_range(start_offset_, head - start_offset_);
+		committed_head_ = start_offset_;
+		decommitted_free_.store(0);
+		guard_offsets_.clear();
+		guard_bytes_.store(start_offset_);
+		return;
 	}
+
+	// guards inside the range go back to plain pages for the bump path
+	const std::set<std::size_t> guards = guard_offsets_;
+	for(std::size_t offset : guards) remove_guard(offset);
+}
+
+void PageAllocator::decommit_pages(void* ptr, std::size_t size){
+	if(!ptr || size == 0) return;
+	assert(owns(ptr) && "pages outside the reserved range");
+	assert(reinterpret_cast<std::uintptr_t>(ptr) % page_size_ == 0
+		&& size % page_size_ == 0 && "decommit_pages takes whole pages");
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	const std::size_t offset = utils::ptr_diff<std::byte>(ptr, base_ptr_);
+	decommit_range(offset, size);
+	lent_holes_.emplace(offset, size);
+}
+
+bool PageAllocator::recommit_pages(void* ptr, std::size_t size){
+	if(!ptr || size == 0) return true;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	const std::size_t offset = utils::ptr_diff<std::byte>(ptr, base_ptr_);
+	// a reset in between already recommitted them
+	auto it = lent_holes_.find(offset);
+	if(it == lent_holes_.end()) return true;
+	assert(it->second == size && "recommit_pages must match decommit_pages");
+
+	lent_holes_.erase(it);
+	if(!recommit_range(offset, size)){
+		lent_holes_.emplace(offset, size);
+		return false;
+	}
+	return true;
+}
+
+void PageAllocator::set_budget(MemoryBudget* budget){
+	std::lock_guard<std::mutex> lock(mutex_);
+	const std::size_t committed = committed_bytes();
+	if(budget_) budget_->release(committed);
+	budget_ = budget;
+	if(budget_) budget_->charge(committed);
+}
+
+PageAllocatorStats PageAllocator::stats() const noexcept{
+	PageAllocatorStats s;
+	s.reserved = reserved_size_;
+	s.committed = committed_bytes();
+	s.peak_committed = peak_committed_.load();
+	s.commit_calls = commit_calls_.load();
+	s.decommit_calls = decommit_calls_.load();
+	s.prefaulted = prefaulted_.load();
+	s.free_bytes = free_bytes_.load();
+	s.free_ranges = free_ranges_.load();
+	return s;
 }
 
 } //namespace engine::mem
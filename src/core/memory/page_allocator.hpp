@@ -1,13 +1,77 @@
 #pragma once
 
 #include<algorithm>
+#include<atomic>
+#include<condition_variable>
+#include<cstdint>
+#include<map>
 #include<mutex>
+#include<set>
+#include<utility>
+#include<vector>
 
 #include"virtual_memory.hpp"
 #include"allocator_utils.hpp"
+#include"allocator_stats.hpp"
+#include"memory_budget.hpp"
+#include"page_worker.hpp"
 
 namespace engine::mem::allocator{
 
+struct PageAllocatorDesc{
+	std::size_t max_size_bytes = 0;
+
+	//size of the private chunk each thread carves from the reserved range
+	//	requests up to thread_chunk_bytes / 4 are served from it without
+	//	locking, frees of blocks inside a chunk are ignored until reset()
+	//	while over-aligned ones take the locked path and are recycled
+	//	0 disables the thread path
+	std::size_t thread_chunk_bytes = 0;
+
+	//back the range with huge pages when the OS provides them
+	//	the reservation is aligned and committed in huge page units,
+	//	check page_backing() for what was actually obtained
+	bool huge_pages = false;
+
+	//NUMA placement of committed pages, Local follows the thread
+	//	whose allocation triggers the commit
+	//	ignored on single node machines
+	os::NumaPolicy numa_policy = os::NumaPolicy::FirstTouch;
+	int numa_node = 0;
+
+	//return the pages of out of order frees to the OS right away,
+	//	they are recommitted when a later allocation reuses them
+	bool decommit_freed = false;
+
+	//run decommits (reset(true), decommit_freed) on this worker instead
+	//	of the calling thread, pages being reclaimed are not handed out
+	//	again until the worker is done with them
+	//	must outlive the allocator, nullptr keeps them synchronous
+	PageWorker* worker = nullptr;
+	//LazyFree leaves reclaiming to the kernel under memory pressure
+	os::ReclaimMode reclaim_mode = os::ReclaimMode::Decommit;
+
+	//each commit reaches this many bytes past the request, so the
+	//	following allocations find their pages committed already
+	std::size_t commit_ahead_bytes = 0;
+	//fault committed pages in during the commit instead of on first use,
+	//	with a worker and Populate the faults happen on the worker
+	os::PrefaultMode prefault = os::PrefaultMode::None;
+
+	//put an inaccessible page after every block and one at the start of
+	//	the range, so overruns between neighbours fault at once
+	//	costs a page of address space per block but no RAM,
+	//	thread chunk requests are not guarded
+	bool guard_pages = false;
+};
+
+// bump allocator over a reserved range, requests outside the thread
+//	chunks take whole pages, so any of them can be freed: the top one
+//	lowers the bump offset, others go to a coalescing list of free page
+//	runs that allocate searches best fit first
+//	that costs a page per request, a 64 byte block takes a 4 KiB page of
+//	range and commit, so small objects belong in the thread chunks or in
+//	an allocator layered on top
 class PageAllocator{
 public:
 	PageAllocator() = default;
@@ -17,6 +81,7 @@ public:
 	PageAllocator& operator=(const PageAllocator&) = delete;
 
 	void init(std::size_t max_size_bytes);
+	void init(const PageAllocatorDesc& desc);
 	void shutdown();
 
 	[[nodiscard]] void*allocate(std::size_t size, std::size_t alignment);
@@ -24,15 +89,117 @@ public:
 
 	void reset(bool decommit_unused = false);
 
-	std::size_t committed_bytes() const {return committed_head_;}
+	//decommits whole pages inside a live block and keeps the accounting,
+	//	the block must recommit them before it is freed, reset() does
+	//	it for blocks it invalidates
+	void decommit_pages(void* ptr, std::size_t size);
+	//false when the OS refuses, the pages then stay decommitted
+	[[nodiscard]] bool recommit_pages(void* ptr, std::size_t size);
+
+	std::size_t committed_bytes() const {
+		return committed_head_.load(std::memory_order_relaxed)
+			- decommitted_free_.load() - guard_bytes_.load();
+	}
 	std::size_t reserved_bytes() const {return reserved_size_;}
 
+	//true if p lies inside the reserved range
+	bool owns(const void* p) const{
+		auto addr = reinterpret_cast<std::uintptr_t>(p);
+		auto base = reinterpret_cast<std::uintptr_t>(base_ptr_);
+		return addr >= base && addr < base + reserved_size_;
+	}
+
+	//commit granularity
+	std::size_t page_size() const {return page_size_;}
+	os::PageBacking page_backing() const {return page_backing_;}
+	//FirstTouch when the machine has a single node
+	os::NumaPolicy numa_policy() const {return numa_policy_;}
+
+	//safe to sample from any thread
+	[[nodiscard]] PageAllocatorStats stats() const noexcept;
+
+	//charges committed bytes to budget, nullptr detaches
+	void set_budget(MemoryBudget* budget);
+
 private:
+	void* allocate_locked(std::size_t size, std::size_t alignment);
+	void* allocate_thread_local(std::size_t size, std::size_t alignment);
+
+	//lock-free bump of current_offset_, returns aligned start offset
+	bool reserve_range(std::size_t size, std::size_t alignment,
+			std::size_t& out_offset);
+	bool commit_up_to_locked(std::size_t end_offset);
+
+	//free page runs, all under mutex_
+	bool take_free_range(std::size_t size, std::size_t alignment,
+			std::size_t& out_offset);
+	void insert_free_range(std::size_t offset, std::size_t size);
+	void erase_free_range(std::map<std::size_t, std::size_t>::iterator it);
+	//moves a free run ending at top back under the bump offset
+	void absorb_free_tail(std::size_t top);
+	bool recommit_range(std::size_t offset, std::size_t size);
+	void decommit_range(std::size_t offset, std::size_t size);
+
+	//decommit on the worker when there is one, under mutex_
+	void reclaim_range(std::size_t offset, std::size_t size);
+	//freshly committed pages only, Touch writes to them
+	void prefault_range(std::size_t offset, std::size_t size);
+	void submit_to_worker(PageWorker::Job job, std::size_t offset);
+
+	void add_guard(std::size_t offset);
+	void remove_guard(std::size_t offset);
+	static void on_worker_done(void* context, void* ptr, std::size_t size);
+	//blocks while the worker still owns part of the range
+	void wait_for_worker(std::size_t offset, std::size_t size);
+
 	void* base_ptr_ = nullptr;
 	std::size_t reserved_size_ = 0;
-	std::size_t current_offset_ = 0;
-	std::size_t committed_head_ = 0;
+	std::atomic<std::size_t> current_offset_ = 0;
+	std::atomic<std::size_t> committed_head_ = 0;
 	std::size_t page_size_ = 0;
+	os::PageBacking page_backing_ = os::PageBacking::Regular;
+	os::NumaPolicy numa_policy_ = os::NumaPolicy::FirstTouch;
+	int numa_node_ = 0;
+
+	std::size_t thread_chunk_bytes_ = 0;
+	std::size_t thread_request_limit_ = 0;
+	//invalidates thread chunks on reset/shutdown
+	std::atomic<std::uint64_t> epoch_ = 0;
+	//start offsets of the chunks carved since the last reset, under mutex_
+	std::set<std::size_t> thread_chunks_;
+
+	bool decommit_freed_ = false;
+	//offset -> size, and (size, offset) for best fit
+	std::map<std::size_t, std::size_t> free_by_offset_;
+	std::set<std::pair<std::size_t, std::size_t>> free_by_size_;
+	//offset -> size decommitted through decommit_pages
+	std::map<std::size_t, std::size_t> lent_holes_;
+
+	PageWorker* worker_ = nullptr;
+	os::ReclaimMode reclaim_mode_ = os::ReclaimMode::Decommit;
+	std::size_t commit_ahead_bytes_ = 0;
+	os::PrefaultMode prefault_ = os::PrefaultMode::None;
+
+	bool guard_pages_ = false;
+	//the leading guard page when guard_pages_ is set, else 0
+	std::size_t start_offset_ = 0;
+	std::set<std::size_t> guard_offsets_;
+	//(offset, size) queued on the worker
+	std::vector<std::pair<std::size_t, std::size_t>> worker_jobs_;
+	std::condition_variable_any worker_cv_;
+
+	//written under mutex_ only
+	RelaxedCounter free_bytes_;
+	RelaxedCounter free_ranges_;
+	RelaxedCounter decommitted_free_;
+	RelaxedCounter guard_bytes_;
+	RelaxedCounter peak_committed_;
+	RelaxedCounter commit_calls_;
+	RelaxedCounter decommit_calls_;
+	RelaxedCounter prefaulted_;
+
+	MemoryBudget* budget_ = nullptr;
+
 	std::mutex mutex_;
 };
 static_assert(utils::AllocatorLike<PageAllocator>);
@@ -0,0 +1,65 @@
+#include"page_worker.hpp"
+
+namespace engine::mem::allocator{
+
+using engine::mem::os::VirtualMemory;
+
+PageWorker::PageWorker() : thread_([this]{ run(); }){}
+
+PageWorker::~PageWorker(){
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	work_cv_.notify_one();
+	thread_.join();
+}
+
+void PageWorker::submit(const Job& job){
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		queue_.push_back(job);
+	}
+	work_cv_.notify_one();
+}
+
+void PageWorker::flush(){
+	std::unique_lock<std::mutex> lock(mutex_);
+	idle_cv_.wait(lock, [this]{ return queue_.empty() && !busy_; });
+}
+
+std::size_t PageWorker::pending() const{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return queue_.size() + (busy_ ? 1 : 0);
+}
+
+void PageWorker::run(){
+	std::unique_lock<std::mutex> lock(mutex_);
+	for(;;){
+		work_cv_.wait(lock, [this]{ return stop_ || !queue_.empty(); });
+		// stop only once drained, owners wait on their done callbacks
+		if(queue_.empty()) return;
+
+		const Job job = queue_.front();
+		queue_.pop_front();
+		busy_ = true;
+		lock.unlock();
+
+		if(job.kind == Kind::Reclaim){
+			VirtualMemory::reclaim(job.ptr, job.size, job.mode);
+			bytes_reclaimed_.add(job.size);
+		}
+		else{
+			VirtualMemory::prefault(job.ptr, job.size, os::PrefaultMode::Populate);
+			bytes_prefaulted_.add(job.size);
+		}
+		jobs_done_.add();
+		if(job.done) job.done(job.context, job.ptr, job.size);
+
+		lock.lock();
+		busy_ = false;
+		if(queue_.empty()) idle_cv_.notify_all();
+	}
+}
+
+} // namespace engine::mem::allocator
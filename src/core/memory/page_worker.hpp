@@ -0,0 +1,73 @@
+#pragma once
+
+#include<condition_variable>
+#include<cstddef>
+#include<deque>
+#include<mutex>
+#include<thread>
+
+#include"allocator_stats.hpp"
+#include"virtual_memory.hpp"
+
+namespace engine::mem::allocator{
+
+// background thread running page reclaims and prefaults off the
+//	calling thread, jobs run in submission order, done is called on
+//	the worker thread once a job is finished
+//	the destructor finishes queued jobs first
+class PageWorker{
+public:
+	using Done = void(*)(void* context, void* ptr, std::size_t size);
+
+	enum class Kind{
+		Reclaim,
+		//always os::PrefaultMode::Populate, touching could race with
+		//	whoever already uses the pages
+		Prefault
+	};
+
+	struct Job{
+		Kind kind = Kind::Reclaim;
+		void* ptr = nullptr;
+		std::size_t size = 0;
+		os::ReclaimMode mode = os::ReclaimMode::Decommit;
+		Done done = nullptr;
+		void* context = nullptr;
+	};
+
+	PageWorker();
+	~PageWorker();
+
+	PageWorker(const PageWorker&) = delete;
+	PageWorker& operator=(const PageWorker&) = delete;
+
+	void submit(const Job& job);
+
+	//blocks until every job submitted so far has run
+	void flush();
+
+	[[nodiscard]] std::size_t pending() const;
+	[[nodiscard]] std::size_t jobs_done() const noexcept {return jobs_done_.load();}
+	[[nodiscard]] std::size_t bytes_reclaimed() const noexcept {return bytes_reclaimed_.load();}
+	[[nodiscard]] std::size_t bytes_prefaulted() const noexcept {return bytes_prefaulted_.load();}
+
+private:
+	void run();
+
+	mutable std::mutex mutex_;
+	std::condition_variable work_cv_;
+	std::condition_variable idle_cv_;
+	std::deque<Job> queue_;
+	bool busy_ = false;
+	bool stop_ = false;
+
+	//written by the worker thread only
+	RelaxedCounter jobs_done_;
+	RelaxedCounter bytes_reclaimed_;
+	RelaxedCounter bytes_prefaulted_;
+
+	//last, starts once everything above is constructed
+	std::thread thread_;
+};
+
+} // namespace engine::mem::allocator
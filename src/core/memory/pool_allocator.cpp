@@ -20,35 +20,17 @@ PoolAllocator::PoolAllocator(
 		"alignment must be at least pointer size");
 	assert(count > 0 && "pool count must be > 0");
 
-	std::size_t stride = utils::align_up(elem_size_, alignment_);
-	total_bytes_ = stride * count;
+	stride_ = utils::align_up(elem_size_, alignment_);
+	total_bytes_ = stride_ * count;
 	memory_ = static_cast<std::byte*>(
 		backing.allocate(total_bytes_, alignment)
 	);
 
 	assert(memory_ && "failed to allocate pool memory");
-
-	init_free_list();
-}
-
-void PoolAllocator::init_free_list() noexcept{
-	if(!memory_) return;
-
-	std::size_t stride = utils::align_up(elem_size_, alignment_);
-
-	for(std::size_t i = 0; i < capacity_count_ - 1; ++i){
-		void* curr = utils::ptr_add<void>(memory_, i * stride);
-		void* next = utils::ptr_add<void>(memory_, (i+1) * stride);
-		*static_cast<void**>(curr) = next;
-	}
-
-	void* last = utils::ptr_add<void>(memory_, (capacity_count_ - 1)*stride);
-	*static_cast<void**>(last) = nullptr;
-
-	free_head_ = memory_;
 }
 
 PoolAllocator::~PoolAllocator() noexcept{
+	if(budget_) budget_->release(live_.load() * stride_);
 	if(backing_allocator_ && memory_){
 		backing_allocator_->deallocate(memory_, total_bytes_);
 	}
@@ -61,11 +43,25 @@ void* PoolAllocator::allocate(
 
 	assert(size <= elem_size_ && "object too large for this pool");
 
-	if(!free_head_) return nullptr;
+	void*r = nullptr;
+	if(free_head_){
+		r = free_head_;
+		//move head to next element from list
+		free_head_ = *reinterpret_cast<void**>(free_head_);
+	}
+	else if(next_untouched_ < capacity_count_){
+		//never used slot, its page is faulted in only now
+		r = utils::ptr_add<void>(memory_, next_untouched_ * stride_);
+		++next_untouched_;
+	}
+	else{
+		failed_allocs_.add();
+		return nullptr;
+	}
 
-	void*r = free_head_;
-	//move head to next element from list
-	free_head_ = *reinterpret_cast<void**>(free_head_);
+	live_.add();
+	high_water_.raise_to(live_.load());
+	if(budget_) budget_->charge(stride_);
 	return r;
 }
 
@@ -73,20 +69,31 @@ void PoolAllocator::deallocate(void* p) noexcept{
 	if(!p) return;
 	*static_cast<void**>(p) = free_head_;
 	free_head_ = p;
+	live_.sub();
+	if(budget_) budget_->release(stride_);
 }
 
 void PoolAllocator::reset() noexcept { 
-	init_free_list(); 
+	if(budget_) budget_->release(live_.load() * stride_);
+	free_head_ = nullptr;
+	next_untouched_ = 0;
+	live_.store(0);
 }
 
-std::size_t PoolAllocator::free_count() const noexcept{
-	std::size_t cnt = 0;
-	void* cur = free_head_;
-	while(cur) {
-		++cnt;
-		cur = *reinterpret_cast<void**>(cur);
-	}
-	return cnt;
+void PoolAllocator::set_budget(MemoryBudget* budget) noexcept{
+	if(budget_) budget_->release(live_.load() * stride_);
+	budget_ = budget;
+	if(budget_) budget_->charge(live_.load() * stride_);
+}
+
+PoolStats PoolAllocator::stats() const noexcept{
+	PoolStats s;
+	s.capacity = capacity_count_;
+	s.live = live_.load();
+	s.free = s.capacity - s.live;
+	s.high_water = high_water_.load();
+	s.failed_allocs = failed_allocs_.load();
+	return s;
 }
 
 }// namespace engine::mem::allocator
@@ -1,6 +1,8 @@
 #pragma once
 
 #include"allocator_utils.hpp"
+#include"allocator_stats.hpp"
+#include"memory_budget.hpp"
 #include"page_allocator.hpp"
 
 namespace engine::mem::allocator{
@@ -17,22 +19,38 @@ public:
 
 	[[nodiscard]] void* allocate(const std::size_t size, const std::size_t align);
 	void deallocate(void* p) noexcept;
+	//O(1), forgets every slot without touching the memory
 	void reset() noexcept;
 
 	[[nodiscard]] std::size_t capacity() const noexcept {return capacity_count_;}
-	[[nodiscard]] std::size_t free_count() const noexcept;
+	[[nodiscard]] std::size_t free_count() const noexcept{
+		return capacity_count_ - live_.load();
+	}
 
-private:
-	void init_free_list() noexcept;
+	//safe to sample from any thread
+	[[nodiscard]] PoolStats stats() const noexcept;
+
+	//charges live slots (stride bytes each) to budget, nullptr detaches
+	void set_budget(MemoryBudget* budget) noexcept;
 
+private:
 	std::byte* memory_ = nullptr;
+	//only slots that were handed out and returned
 	void* free_head_ = nullptr;
+	//slots at and past this index were never touched
+	std::size_t next_untouched_ = 0;
 
 	std::size_t elem_size_ = 0;
 	std::size_t capacity_count_ = 0;
 	std::size_t alignment_ = 0;
+	std::size_t stride_ = 0;
 	std::size_t total_bytes_ = 0;
 
+	RelaxedCounter live_;
+	RelaxedCounter high_water_;
+	RelaxedCounter failed_allocs_;
+
+	MemoryBudget* budget_ = nullptr;
 	PageAllocator* backing_allocator_ = nullptr;
 };
 static_assert(utils::PoolLike<PoolAllocator>);
@@ -0,0 +1,87 @@
+#include<algorithm>
+#include<mutex>
+#include<optional>
+
+#include"scratch_arena.hpp"
+
+namespace engine::mem::allocator{
+
+namespace{
+
+struct Registry{
+	std::mutex mutex;
+	VirtualArenaDesc desc = [] {
+		VirtualArenaDesc d;
+		d.reserve_bytes = 64 * 1024 * 1024;
+		d.decommit_watermark = 1024 * 1024;
+		return d;
+	}();
+	std::vector<std::pair<std::thread::id, VirtualArena*>> arenas;
+};
+
+Registry& registry(){
+	static Registry r;
+	return r;
+}
+
+// registers on first use, unregisters on thread exit
+struct ThreadScratch{
+	std::optional<VirtualArena> arena;
+	//live ScratchScopes, the last one out resets the arena
+	std::size_t depth = 0;
+
+	~ThreadScratch(){
+		if(!arena) return;
+		Registry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		std::erase_if(r.arenas, [this](const auto& e){return e.second == &*arena;});
+	}
+};
+
+thread_local ThreadScratch t_scratch;
+
+} // namespace
+
+VirtualArena& ScratchArenas::local(){
+	if(t_scratch.arena) return *t_scratch.arena;
+
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	t_scratch.arena.emplace(r.desc);
+	r.arenas.emplace_back(std::this_thread::get_id(), &*t_scratch.arena);
+	return *t_scratch.arena;
+}
+
+void ScratchArenas::set_desc(const VirtualArenaDesc& desc){
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	r.desc = desc;
+}
+
+std::vector<ScratchArenaStats> ScratchArenas::snapshot(){
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+
+	std::vector<ScratchArenaStats> out;
+	out.reserve(r.arenas.size());
+	for(const auto& [id, arena] : r.arenas){
+		const ArenaStats s = arena->stats();
+		out.push_back({id, s.in_use, s.peak, arena->committed_bytes()});
+	}
+	return out;
+}
+
+ScratchScope::ScratchScope()
+		: arena_(ScratchArenas::local()), marker_(arena_.get_marker()){
+	++t_scratch.depth;
+}
+
+ScratchScope::~ScratchScope() noexcept{
+	// a marker of 0 only means nothing was allocated yet, an enclosing
+	//	scope may still be live, and the outermost one keeps whatever
+	//	was allocated outside any scope
+	if(--t_scratch.depth == 0 && marker_ == 0) arena_.reset();
+	else arena_.rollback(marker_);
+}
+
+} // namespace engine::mem::allocator
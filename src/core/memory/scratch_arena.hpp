@@ -0,0 +1,56 @@
+#pragma once
+
+#include<thread>
+#include<vector>
+
+#include"allocator_stats.hpp"
+#include"virtual_arena.hpp"
+
+namespace engine::mem::allocator{
+
+struct ScratchArenaStats{
+	std::thread::id thread;
+	std::size_t in_use = 0;
+	std::size_t peak = 0;
+	std::size_t committed = 0;
+};
+
+// per thread scratch memory, each thread lazily gets its own VirtualArena
+//	so allocation never synchronizes, only thread start/exit and
+//	snapshot() touch the registry lock
+struct ScratchArenas{
+	//arena of the calling thread, created on first use
+	[[nodiscard]] static VirtualArena& local();
+
+	//settings for arenas created from now on
+	static void set_desc(const VirtualArenaDesc& desc);
+
+	//every live thread arena, safe to call from any thread
+	[[nodiscard]] static std::vector<ScratchArenaStats> snapshot();
+};
+
+// scratch allocation scope on the calling thread's arena
+//	the arena rolls back on exit, the outermost scope of an otherwise
+//	empty arena resets it so the decommit watermark applies
+class ScratchScope{
+public:
+	ScratchScope();
+	~ScratchScope() noexcept;
+
+	ScratchScope(const ScratchScope&) = delete;
+	ScratchScope& operator=(const ScratchScope&) = delete;
+
+	[[nodiscard]] void* allocate(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t)) noexcept{
+		return arena_.allocate(size, alignment);
+	}
+
+	[[nodiscard]] VirtualArena& arena() noexcept {return arena_;}
+
+private:
+	VirtualArena& arena_;
+	VirtualArena::Marker marker_;
+};
+
+} // namespace engine::mem::allocator
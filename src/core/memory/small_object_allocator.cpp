@@ -0,0 +1,104 @@
+#include<cassert>
+#include<algorithm>
+
+#include"small_object_allocator.hpp"
+
+namespace engine::mem::allocator{
+
+namespace{
+
+using Self = SmallObjectAllocator;
+
+// 16 B steps up to 128, then four classes per power of two
+constexpr std::array<std::uint16_t, Self::kClassCount> kClassSizes = {
+	16, 32, 48, 64, 80, 96, 112, 128,
+	160, 192, 224, 256,
+	320, 384, 448, 512,
+	640, 768, 896, 1024,
+	1280, 1536, 1792, 2048,
+	2560, 3072, 3584, 4096
+};
+static_assert(kClassSizes.back() == Self::kMaxSmallSize);
+
+constexpr std::size_t kLookupStep = Self::kMinSmallSize;
+
+// (size + 15) / 16 -> class index
+constexpr auto kClassLookup = []{
+	std::array<std::uint8_t, Self::kMaxSmallSize / kLookupStep + 1> table{};
+	std::size_t c = 0;
+	for(std::size_t i = 0; i < table.size(); ++i){
+		while(kClassSizes[c] < i * kLookupStep) ++c;
+		table[i] = static_cast<std::uint8_t>(c);
+	}
+	return table;
+}();
+
+// largest power of two dividing the class size, slots of a class are
+// naturally aligned to it
+constexpr auto kClassAlign = []{
+	std::array<std::uint16_t, Self::kClassCount> align{};
+	for(std::size_t i = 0; i < align.size(); ++i){
+		align[i] = static_cast<std::uint16_t>(kClassSizes[i] & (~kClassSizes[i] + 1));
+	}
+	return align;
+}();
+
+} // namespace
+
+SmallObjectAllocator::SmallObjectAllocator(
+			PageAllocator& backing,
+			bool release_empty_slabs)
+		: backing_allocator_(&backing),
+		slab_bytes_(std::max(kSlabBytes, backing.page_size())){
+	for(std::size_t i = 0; i < kClassCount; ++i){
+		classes_[i].emplace(backing, kClassSizes[i], slab_bytes_,
+			kClassAlign[i], release_empty_slabs);
+	}
+}
+
+std::size_t SmallObjectAllocator::class_size(std::size_t class_index) noexcept{
+	return class_index < kClassCount ? kClassSizes[class_index] : 0;
+}
+
+std::size_t SmallObjectAllocator::class_index(
+		std::size_t size,
+		std::size_t alignment) noexcept{
+	if(alignment > kMinSmallSize) size = utils::align_up(size, alignment);
+	if(size > kMaxSmallSize) return kClassCount;
+
+	std::size_t c = kClassLookup[(size + kLookupStep - 1) / kLookupStep];
+	//over-aligned requests walk up to the next class aligned enough,
+	//at worst the next power of two
+	while(c < kClassCount && kClassAlign[c] < alignment) ++c;
+	return c;
+}
+
+void* SmallObjectAllocator::allocate(
+		const std::size_t size,
+		const std::size_t alignment) noexcept{
+	const std::size_t c = class_index(size, alignment);
+	if(c == kClassCount){
+		return large_heap_.allocate(size, alignment);
+	}
+	return classes_[c]->allocate(kClassSizes[c], alignment);
+}
+
+void SmallObjectAllocator::deallocate(void* p) noexcept{
+	if(!p) return;
+
+	if(!backing_allocator_->owns(p)){
+		large_heap_.deallocate(p);
+		return;
+	}
+
+	GrowingPoolAllocator* owner = GrowingPoolAllocator::owner_of(p, slab_bytes_);
+	assert(owner && "pointer does not belong to a size class");
+	owner->deallocate(p);
+}
+
+PoolStats SmallObjectAllocator::class_stats(std::size_t class_index) const noexcept{
+	assert(class_index < kClassCount);
+	return classes_[class_index]->stats();
+}
+
+}// namespace engine::mem::allocator
@@ -0,0 +1,56 @@
+#pragma once
+
+#include<array>
+#include<cstdint>
+#include<optional>
+
+#include"allocator_utils.hpp"
+#include"allocator_stats.hpp"
+#include"default_heap.hpp"
+#include"growing_pool_allocator.hpp"
+#include"page_allocator.hpp"
+
+namespace engine::mem::allocator{
+
+// segregated fit allocator for small objects
+//	requests up to kMaxSmallSize are rounded to one of kClassCount size
+//	classes, each served by a GrowingPoolAllocator whose slabs come from
+//	the PageAllocator, the class is found with one table lookup
+//	larger or over-aligned requests fall through to DefaultHeap
+class SmallObjectAllocator{
+public:
+	static constexpr std::size_t kMinSmallSize = 16;
+	static constexpr std::size_t kMaxSmallSize = 4096;
+	static constexpr std::size_t kClassCount = 28;
+	//raised to the backing page size when that is larger
+	static constexpr std::size_t kSlabBytes = 64 * 1024;
+
+	explicit SmallObjectAllocator(PageAllocator& backing,
+			bool release_empty_slabs = false);
+	~SmallObjectAllocator() noexcept = default;
+
+	SmallObjectAllocator(const SmallObjectAllocator&) = delete;
+	SmallObjectAllocator& operator=(const SmallObjectAllocator&) = delete;
+
+	[[nodiscard]] void* allocate(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t)) noexcept;
+	void deallocate(void* p) noexcept;
+
+	[[nodiscard]] static std::size_t class_size(std::size_t class_index) noexcept;
+	//kClassCount if size does not fit any class
+	[[nodiscard]] static std::size_t class_index(
+			std::size_t size,
+			std::size_t alignment = alignof(std::max_align_t)) noexcept;
+
+	[[nodiscard]] PoolStats class_stats(std::size_t class_index) const noexcept;
+
+private:
+	std::array<std::optional<GrowingPoolAllocator>, kClassCount> classes_;
+	PageAllocator* backing_allocator_ = nullptr;
+	std::size_t slab_bytes_ = kSlabBytes;
+	DefaultHeap large_heap_;
+};
+static_assert(utils::AllocatorLike<SmallObjectAllocator>);
+
+} // namespace engine::mem::allocator
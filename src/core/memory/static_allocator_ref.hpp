@@ -0,0 +1,56 @@
+#pragma once
+
+#include<cstddef>
+
+#include"allocator_utils.hpp"
+#include"allocator_handle.hpp"
+
+namespace engine::mem::allocator{
+
+// AllocatorHandle with the allocator type known at compile time
+//	same interface, but every call goes straight to T and inlines,
+//	can_free / can_reset are constants so the branches fold away
+template<utils::AllocatorLike T>
+class StaticAllocatorRef{
+public:
+	static constexpr bool can_free = requires(T& a, void*p){a.deallocate(p);};
+	static constexpr bool can_reset = utils::ArenaLike<T>;
+
+	explicit StaticAllocatorRef(T& allocator) noexcept : impl_(&allocator){}
+
+	[[nodiscard]] void* allocate(
+			const std::size_t size,
+			const std::size_t align = alignof(std::max_align_t)) const{
+		return impl_->allocate(size, align);
+	}
+
+	void deallocate(void* ptr) const{
+		if constexpr(can_free) impl_->deallocate(ptr);
+	}
+
+	void reset() const{
+		if constexpr(can_reset) impl_->reset();
+	}
+
+	[[nodiscard]] T& get() const noexcept {return *impl_;}
+
+	//type erased view for code that cannot be templated
+	[[nodiscard]] AllocatorHandle handle() const requires(can_free || can_reset){
+		if constexpr(utils::PoolLike<T> && can_free && can_reset){
+			return AllocatorHandle::from_pool(*impl_);
+		}
+		else if constexpr(can_free){
+			return AllocatorHandle::from_heap(*impl_);
+		}
+		else{
+			return AllocatorHandle::from_arena(*impl_);
+		}
+	}
+
+	friend bool operator==(const StaticAllocatorRef&, const StaticAllocatorRef&) = default;
+
+private:
+	T* impl_;
+};
+
+} // namespace engine::mem::allocator
@@ -0,0 +1,235 @@
+#include<bit>
+#include<cassert>
+#include<algorithm>
+
+#include"tlsf_allocator.hpp"
+#include"page_allocator.hpp"
+#include"allocator_utils.hpp"
+
+namespace engine::mem::allocator{
+
+TlsfAllocator::TlsfAllocator(PageAllocator& backing, const std::size_t bytes)
+		: capacity_(utils::align_up(bytes, kAlign)),
+		backing_allocator_(&backing){
+	assert(capacity_ >= 2 * kHeaderSize + kMinPayload && "region too small");
+
+	memory_ = static_cast<std::byte*>(backing.allocate(capacity_, kAlign));
+	assert(memory_ && "failed to allocate memory for TlsfAllocator");
+
+	reset();
+}
+
+TlsfAllocator::~TlsfAllocator() noexcept{
+	if(backing_allocator_ && memory_){
+		backing_allocator_->deallocate(memory_, capacity_);
+	}
+}
+
+void TlsfAllocator::reset() noexcept{
+	fl_bitmap_ = 0;
+	std::fill(std::begin(sl_bitmap_), std::end(sl_bitmap_), 0u);
+	for(auto& fl : blocks_) std::fill(std::begin(fl), std::end(fl), nullptr);
+	used_ = 0;
+
+	if(!memory_) return;
+
+	// one free block over the region, closed by a zero sized used sentinel
+	Block* first = reinterpret_cast<Block*>(memory_);
+	first->prev_phys = nullptr;
+	first->size_and_flags = (capacity_ - 2 * kHeaderSize) | kFreeBit;
+
+	Block* sentinel = next_phys(first);
+	sentinel->prev_phys = first;
+	sentinel->size_and_flags = kPrevFreeBit;
+
+	insert_free(first);
+}
+
+void TlsfAllocator::mapping(std::size_t size, unsigned& fl, unsigned& sl) noexcept{
+	if(size < kSmallBlockSize){
+		fl = 0;
+		sl = static_cast<unsigned>(size / (kSmallBlockSize / kSlIndexCount));
+	}
+	else{
+		const auto top = static_cast<unsigned>(std::bit_width(size)) - 1;
+		sl = static_cast<unsigned>(size >> (top - kSlIndexCountLog2)) ^ kSlIndexCount;
+		fl = top - (kFlIndexShift - 1);
+	}
+}
+
+void TlsfAllocator::mapping_search(std::size_t size, unsigned& fl, unsigned& sl) noexcept{
+	// round up to the next bin so any block found there fits
+	if(size >= kSmallBlockSize){
+		const auto top = static_cast<unsigned>(std::bit_width(size)) - 1;
+		size += (std::size_t{1} << (top - kSlIndexCountLog2)) - 1;
+	}
+	mapping(size, fl, sl);
+}
+
+void TlsfAllocator::insert_free(Block* b) noexcept{
+	unsigned fl = 0, sl = 0;
+	mapping(size_of(b), fl, sl);
+
+	Block* head = blocks_[fl][sl];
+	b->next_free = head;
+	b->prev_free = nullptr;
+	if(head) head->prev_free = b;
+	blocks_[fl][sl] = b;
+
+	fl_bitmap_ |= 1u << fl;
+	sl_bitmap_[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::remove_free(Block* b) noexcept{
+	unsigned fl = 0, sl = 0;
+	mapping(size_of(b), fl, sl);
+
+	if(b->prev_free) b->prev_free->next_free = b->next_free;
+	else blocks_[fl][sl] = b->next_free;
+	if(b->next_free) b->next_free->prev_free = b->prev_free;
+
+	if(!blocks_[fl][sl]){
+		sl_bitmap_[fl] &= ~(1u << sl);
+		if(!sl_bitmap_[fl]) fl_bitmap_ &= ~(1u << fl);
+	}
+}
+
+TlsfAllocator::Block* TlsfAllocator::locate_free(std::size_t size) noexcept{
+	unsigned fl = 0, sl = 0;
+	mapping_search(size, fl, sl);
+	if(fl >= kFlIndexCount) return nullptr;
+
+	std::uint32_t sl_map = sl_bitmap_[fl] & (~0u << sl);
+	if(!sl_map){
+		const std::uint32_t fl_map = fl + 1 < 32 ? fl_bitmap_ & (~0u << (fl + 1)) : 0;
+		if(!fl_map) return nullptr;
+
+		fl = static_cast<unsigned>(std::countr_zero(fl_map));
+		sl_map = sl_bitmap_[fl];
+	}
+	sl = static_cast<unsigned>(std::countr_zero(sl_map));
+
+	Block* b = blocks_[fl][sl];
+	remove_free(b);
+	return b;
+}
+
+void TlsfAllocator::mark_free(Block* b) noexcept{
+	b->size_and_flags |= kFreeBit;
+	Block* next = next_phys(b);
+	next->prev_phys = b;
+	next->size_and_flags |= kPrevFreeBit;
+}
+
+void TlsfAllocator::mark_used(Block* b) noexcept{
+	b->size_and_flags &= ~kFreeBit;
+	next_phys(b)->size_and_flags &= ~kPrevFreeBit;
+}
+
+TlsfAllocator::Block* TlsfAllocator::split(Block* b, std::size_t size) noexcept{
+	const std::size_t total = size_of(b);
+	if(total < size + kHeaderSize + kMinPayload) return nullptr;
+
+	Block* rest = utils::ptr_add<Block>(payload_of(b), size);
+	rest->size_and_flags = total - size - kHeaderSize;
+	set_size(b, size);
+
+	mark_free(rest);
+	rest->prev_phys = b;
+	rest->size_and_flags &= ~kPrevFreeBit;
+	if(is_free(b)) rest->size_and_flags |= kPrevFreeBit;
+	return rest;
+}
+
+TlsfAllocator::Block* TlsfAllocator::trim_front(Block* b, std::size_t gap) noexcept{
+	const std::size_t total = size_of(b);
+
+	Block* back = utils::ptr_add<Block>(b, gap);
+	back->size_and_flags = (total - gap) | kFreeBit | kPrevFreeBit;
+	back->prev_phys = b;
+	next_phys(back)->prev_phys = back;
+
+	set_size(b, gap - kHeaderSize);
+	insert_free(b);
+	return back;
+}
+
+TlsfAllocator::Block* TlsfAllocator::merge_prev(Block* b) noexcept{
+	if(!is_prev_free(b)) return b;
+
+	Block* prev = b->prev_phys;
+	remove_free(prev);
+	set_size(prev, size_of(prev) + kHeaderSize + size_of(b));
+	next_phys(prev)->prev_phys = prev;
+	return prev;
+}
+
+TlsfAllocator::Block* TlsfAllocator::merge_next(Block* b) noexcept{
+	Block* next = next_phys(b);
+	if(!is_free(next)) return b;
+
+	remove_free(next);
+	set_size(b, size_of(b) + kHeaderSize + size_of(next));
+	next_phys(b)->prev_phys = b;
+	return b;
+}
+
+void* TlsfAllocator::allocate(
+		const std::size_t size,
+		const std::size_t alignment) noexcept{
+	if(!memory_) return nullptr;
+
+	const std::size_t adjusted = utils::align_up(
+		std::max(size, kMinPayload), kAlign);
+
+	// over-aligned requests search for enough slack to cut a free block
+	// off the front, the gap is either zero or big enough to hold one
+	const std::size_t min_gap = kHeaderSize + kMinPayload;
+	const std::size_t search = alignment > kAlign
+		? adjusted + alignment + min_gap
+		: adjusted;
+
+	Block* b = locate_free(search);
+	if(!b) return nullptr;
+
+	if(alignment > kAlign){
+		const auto payload = reinterpret_cast<std::uintptr_t>(payload_of(b));
+		std::uintptr_t aligned = utils::align_up(payload, alignment);
+		if(aligned != payload && aligned - payload < min_gap){
+			aligned = utils::align_up(payload + min_gap, alignment);
+		}
+		if(aligned != payload){
+			b = trim_front(b, aligned - payload);
+		}
+	}
+
+	if(Block* rest = split(b, adjusted)){
+		Block* after = next_phys(rest);
+		after->prev_phys = rest;
+		after->size_and_flags |= kPrevFreeBit;
+		insert_free(rest);
+	}
+
+	mark_used(b);
+	used_ += size_of(b);
+	return payload_of(b);
+}
+
+void TlsfAllocator::deallocate(void* p) noexcept{
+	if(!p) return;
+
+	Block* b = block_of(p);
+	assert(!is_free(b) && "double free");
+	used_ -= size_of(b);
+
+	mark_free(b);
+	b = merge_prev(b);
+	b = merge_next(b);
+
+	Block* next = next_phys(b);
+	next->prev_phys = b;
+	next->size_and_flags |= kPrevFreeBit;
+	insert_free(b);
+}
+
+}// namespace engine::mem::allocator
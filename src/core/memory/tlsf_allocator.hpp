@@ -0,0 +1,108 @@
+#pragma once
+
+#include<cstdint>
+
+#include"allocator_utils.hpp"
+#include"page_allocator.hpp"
+
+namespace engine::mem::allocator{
+
+// Two-Level Segregated Fit allocator over one region from a PageAllocator
+//	free blocks are binned by a power of two (first level) split into
+//	32 linear steps (second level), two bitmaps find a fitting non-empty
+//	bin with a couple of bit scans, so allocate and deallocate are O(1)
+//	neighbours are coalesced on free through boundary headers
+class TlsfAllocator{
+public:
+	TlsfAllocator(PageAllocator& backing, const std::size_t bytes);
+	~TlsfAllocator() noexcept;
+
+	TlsfAllocator(const TlsfAllocator&) = delete;
+	TlsfAllocator& operator=(const TlsfAllocator&) = delete;
+
+	[[nodiscard]] void* allocate(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t)) noexcept;
+	void deallocate(void* p) noexcept;
+
+	//drops every allocation
+	void reset() noexcept;
+
+	[[nodiscard]] std::size_t in_use() const noexcept {return used_;}
+	[[nodiscard]] std::size_t capacity() const noexcept {return capacity_;}
+
+private:
+	static constexpr std::size_t kAlign = 16;
+	static constexpr unsigned kSlIndexCountLog2 = 5;
+	static constexpr unsigned kSlIndexCount = 1u << kSlIndexCountLog2;
+	static constexpr unsigned kFlIndexShift = kSlIndexCountLog2 + 4; // log2(kAlign)
+	static constexpr unsigned kFlIndexMax = 38;
+	static constexpr unsigned kFlIndexCount = kFlIndexMax - kFlIndexShift + 1;
+	static constexpr std::size_t kSmallBlockSize = std::size_t{1} << kFlIndexShift;
+
+	struct Block{
+		//valid only while the previous block is free
+		Block* prev_phys;
+		//payload size, low bits hold the flags
+		std::size_t size_and_flags;
+		//payload starts here, free blocks keep their bin links in it
+		Block* next_free;
+		Block* prev_free;
+	};
+
+	static constexpr std::size_t kHeaderSize = 2 * sizeof(void*);
+	static constexpr std::size_t kMinPayload = 2 * sizeof(void*);
+	static constexpr std::size_t kFreeBit = 1;
+	static constexpr std::size_t kPrevFreeBit = 2;
+	static_assert(kHeaderSize % kAlign == 0);
+
+	static std::size_t size_of(const Block* b) noexcept{
+		return b->size_and_flags & ~(kFreeBit | kPrevFreeBit);
+	}
+	static void set_size(Block* b, std::size_t size) noexcept{
+		b->size_and_flags = size | (b->size_and_flags & (kFreeBit | kPrevFreeBit));
+	}
+	static bool is_free(const Block* b) noexcept{return b->size_and_flags & kFreeBit;}
+	static bool is_prev_free(const Block* b) noexcept{
+		return b->size_and_flags & kPrevFreeBit;
+	}
+	static void* payload_of(Block* b) noexcept{
+		return utils::ptr_add<void>(b, kHeaderSize);
+	}
+	static Block* block_of(void* p) noexcept{
+		return reinterpret_cast<Block*>(
+			reinterpret_cast<std::uintptr_t>(p) - kHeaderSize);
+	}
+	static Block* next_phys(Block* b) noexcept{
+		return utils::ptr_add<Block>(payload_of(b), size_of(b));
+	}
+
+	static void mapping(std::size_t size, unsigned& fl, unsigned& sl) noexcept;
+	static void mapping_search(std::size_t size, unsigned& fl, unsigned& sl) noexcept;
+
+	void insert_free(Block* b) noexcept;
+	void remove_free(Block* b) noexcept;
+	Block* locate_free(std::size_t size) noexcept;
+
+	void mark_free(Block* b) noexcept;
+	void mark_used(Block* b) noexcept;
+	//split b to size, returns the free remainder or nullptr
+	Block* split(Block* b, std::size_t size) noexcept;
+	//cut off the first gap bytes of free block b as their own free block
+	Block* trim_front(Block* b, std::size_t gap) noexcept;
+	Block* merge_prev(Block* b) noexcept;
+	Block* merge_next(Block* b) noexcept;
+
+	std::uint32_t fl_bitmap_ = 0;
+	std::uint32_t sl_bitmap_[kFlIndexCount] = {};
+	Block* blocks_[kFlIndexCount][kSlIndexCount] = {};
+
+	std::byte* memory_ = nullptr;
+	std::size_t capacity_ = 0;
+	std::size_t used_ = 0;
+
+	PageAllocator* backing_allocator_ = nullptr;
+};
+static_assert(utils::AllocatorLike<TlsfAllocator>);
+
+} // namespace engine::mem::allocator
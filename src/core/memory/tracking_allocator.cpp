@@ -0,0 +1,78 @@
+#include<chrono>
+#include<cstdio>
+#include<cstring>
+#include<algorithm>
+
+#include"tracking_allocator.hpp"
+
+namespace engine::mem::allocator::tracking{
+
+namespace{
+
+const char* tag_name(const char* tag){
+	return tag ? tag : "untagged";
+}
+
+thread_local const CallSite* t_call_site = nullptr;
+
+} // namespace
+
+void default_corruption_handler(const AllocationRecord& record, const char* what){
+	std::fprintf(stderr,
+		"[memory] %s of block %p (%zu bytes, tag %s) allocated at %s:%u in %s\n",
+		what, record.ptr, record.size, tag_name(record.tag),
+		record.where.file_name(),
+		static_cast<unsigned>(record.where.line()),
+		record.where.function_name());
+}
+
+void dump_records(std::FILE* out, const char* name,
+		std::vector<AllocationRecord> records){
+	std::size_t total = 0;
+	for(const auto& r : records) total += r.size;
+	std::fprintf(out, "[memory] %s: %zu live allocations, %zu bytes\n",
+		tag_name(name), records.size(), total);
+
+	std::sort(records.begin(), records.end(),
+		[](const AllocationRecord& a, const AllocationRecord& b){
+			const int c = std::strcmp(tag_name(a.tag), tag_name(b.tag));
+			return c != 0 ? c < 0 : a.timestamp_ns < b.timestamp_ns;
+		});
+
+	for(std::size_t i = 0; i < records.size();){
+		const char* tag = tag_name(records[i].tag);
+		std::size_t end = i, bytes = 0;
+		while(end < records.size() && std::strcmp(tag_name(records[end].tag), tag) == 0){
+			bytes += records[end++].size;
+		}
+
+		std::fprintf(out, "  %s: %zu allocations, %zu bytes\n", tag, end - i, bytes);
+		for(; i < end; ++i){
+			const AllocationRecord& r = records[i];
+			std::fprintf(out, "    %p %zu bytes (align %zu) at %s:%u\n",
+				r.ptr, r.size, r.alignment,
+				r.where.file_name(), static_cast<unsigned>(r.where.line()));
+		}
+	}
+}
+
+std::uint64_t now_ns() noexcept{
+	return static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+CallSite::CallSite(std::source_location where) noexcept
+		: where_(where), outer_(t_call_site){
+	t_call_site = this;
+}
+
+CallSite::~CallSite() noexcept{
+	t_call_site = outer_;
+}
+
+const CallSite* current_call_site() noexcept{
+	return t_call_site;
+}
+
+} // namespace engine::mem::allocator::tracking
@@ -0,0 +1,333 @@
+#pragma once
+
+#include<algorithm>
+#include<cassert>
+#include<cstdint>
+#include<cstdio>
+#include<cstring>
+#include<mutex>
+#include<source_location>
+#include<unordered_map>
+#include<vector>
+
+#include"allocator_utils.hpp"
+
+namespace engine::mem::allocator{
+
+#if defined(ENGINE_MEMORY_TRACKING)
+inline constexpr bool kTrackingEnabled = true;
+#else
+inline constexpr bool kTrackingEnabled = false;
+#endif
+
+struct AllocationRecord{
+	const void* ptr = nullptr;
+	std::size_t size = 0;
+	std::size_t alignment = 0;
+	const char* tag = nullptr;
+	//caller of allocate, see tracking::CallSite for handle users
+	std::source_location where;
+	std::uint64_t timestamp_ns = 0;
+};
+
+//called when a guard is found overwritten, what names the damaged side
+using CorruptionHandler = void(*)(const AllocationRecord& record, const char* what);
+
+namespace tracking{
+
+//prints the damaged block to stderr
+void default_corruption_handler(const AllocationRecord& record, const char* what);
+
+//prints live records grouped by tag, with count and bytes per tag
+void dump_records(std::FILE* out, const char* name,
+		std::vector<AllocationRecord> records);
+
+[[nodiscard]] std::uint64_t now_ns() noexcept;
+
+// an AllocatorHandle forwards through a lambda, so blocks it allocates
+//	would all record that lambda as their call site, while a CallSite
+//	lives every tracked allocation on its thread records the CallSite's
+//	location instead, innermost one wins
+class CallSite{
+public:
+	explicit CallSite(std::source_location where = std::source_location::current()) noexcept;
+	~CallSite() noexcept;
+
+	CallSite(const CallSite&) = delete;
+	CallSite& operator=(const CallSite&) = delete;
+
+	[[nodiscard]] const std::source_location& where() const noexcept {return where_;}
+
+private:
+	std::source_location where_;
+	const CallSite* outer_ = nullptr;
+};
+
+//innermost live CallSite of the calling thread, nullptr if there is none
+[[nodiscard]] const CallSite* current_call_site() noexcept;
+
+template<typename T>
+concept CanFree = requires(T& a, void* p){ a.deallocate(p); };
+
+template<typename T>
+concept CanFreeSized = requires(T& a, void* p, std::size_t n){ a.deallocate(p, n); };
+
+} // namespace tracking
+
+template<utils::AllocatorLike Alloc, bool Enabled = kTrackingEnabled>
+class TrackingAllocator;
+
+// tracking compiled out, every call forwards straight to the wrapped allocator
+template<utils::AllocatorLike Alloc>
+class TrackingAllocator<Alloc, false>{
+public:
+	explicit TrackingAllocator(Alloc& inner, const char* /*tag*/ = nullptr) noexcept
+		: inner_(inner){}
+
+	[[nodiscard]] void* allocate(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t),
+			const char* /*tag*/ = nullptr,
+			const std::source_location /*where*/ = std::source_location::current()){
+		return inner_.allocate(size, alignment);
+	}
+
+	void deallocate(void* p) requires tracking::CanFree<Alloc> {inner_.deallocate(p);}
+	void deallocate(void* p, const std::size_t n) requires tracking::CanFreeSized<Alloc>{
+		inner_.deallocate(p, n);
+	}
+	void reset() requires utils::ArenaLike<Alloc> {inner_.reset();}
+
+	void set_corruption_handler(CorruptionHandler) noexcept {}
+	[[nodiscard]] constexpr std::size_t live_count() const noexcept {return 0;}
+	[[nodiscard]] constexpr std::size_t live_bytes() const noexcept {return 0;}
+	[[nodiscard]] constexpr std::size_t corruption_count() const noexcept {return 0;}
+	constexpr bool check() noexcept {return true;}
+	void dump_live(std::FILE* = stderr) const noexcept {}
+
+	[[nodiscard]] Alloc& inner() noexcept {return inner_;}
+
+private:
+	Alloc& inner_;
+};
+
+// records call site, size, alignment, tag and time of every live block
+//	and surrounds it with guard bytes checked on free, on reset and by
+//	check(), blocks still live at destruction are dumped by tag
+//	layout: [pad][Header][front guard][user block][back guard]
+//	a fixed slot pool has no room for header and guards, its blocks are
+//	recorded out of band and only get the freed byte fill
+template<utils::AllocatorLike Alloc>
+class TrackingAllocator<Alloc, true>{
+public:
+	explicit TrackingAllocator(Alloc& inner, const char* tag = nullptr) noexcept
+		: inner_(inner), tag_(tag){}
+
+	~TrackingAllocator(){
+		// arenas drop blocks without freeing them, only heaps can leak
+		if constexpr(kCanFree){
+			if(live_count_ > 0) dump_live(stderr);
+		}
+	}
+
+	TrackingAllocator(const TrackingAllocator&) = delete;
+	TrackingAllocator& operator=(const TrackingAllocator&) = delete;
+
+	[[nodiscard]] void* allocate(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t),
+			const char* tag = nullptr,
+			const std::source_location where = std::source_location::current()){
+		const tracking::CallSite* site = tracking::current_call_site();
+		if constexpr(kFixedSlots){
+			void* p = inner_.allocate(size, alignment);
+			if(!p) return nullptr;
+			std::lock_guard<std::mutex> lock(mutex_);
+			slot_records_.emplace(p, AllocationRecord{p, size, alignment,
+				tag ? tag : tag_, site ? site->where() : where, tracking::now_ns()});
+			++live_count_;
+			live_bytes_ += size;
+			return p;
+		}
+
+		const std::size_t align = std::max(alignment, alignof(Header));
+		const std::size_t front = utils::align_up(sizeof(Header) + kGuardBytes, align);
+		const std::size_t total = front + size + kGuardBytes;
+
+		void* base = inner_.allocate(total, align);
+		if(!base) return nullptr;
+
+		std::byte* user = static_cast<std::byte*>(base) + front;
+		Header* h = header_of(user);
+		h->base = base;
+		h->total = total;
+		h->record = AllocationRecord{user, size, alignment, tag ? tag : tag_,
+			site ? site->where() : where, tracking::now_ns()};
+
+		std::memset(user - kGuardBytes, kGuardByte, kGuardBytes);
+		std::memset(user + size, kGuardByte, kGuardBytes);
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		link(h);
+		return user;
+	}
+
+	void deallocate(void* p) requires kCanFree {
+		if(!p) return;
+		if constexpr(kFixedSlots){
+			release_slot(p);
+			inner_.deallocate(p);
+			return;
+		}
+		void* base = nullptr;
+		std::size_t total = 0;
+		release(p, base, total);
+		if constexpr(tracking::CanFree<Alloc>) inner_.deallocate(base);
+		else inner_.deallocate(base, total);
+	}
+	//size is taken from the header
+	void deallocate(void* p, const std::size_t /*n*/) requires kCanFree {deallocate(p);}
+
+	void reset() requires utils::ArenaLike<Alloc> {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for(Header* h = head_; h; h = h->next) check_block(h);
+			head_ = nullptr;
+			slot_records_.clear();
+			live_count_ = 0;
+			live_bytes_ = 0;
+		}
+		inner_.reset();
+	}
+
+	void set_corruption_handler(CorruptionHandler handler) noexcept {handler_ = handler;}
+
+	[[nodiscard]] std::size_t live_count() const noexcept {return live_count_;}
+	[[nodiscard]] std::size_t live_bytes() const noexcept {return live_bytes_;}
+	[[nodiscard]] std::size_t corruption_count() const noexcept {return corruptions_;}
+
+	//checks the guards of every live block, false if any was damaged
+	bool check(){
+		std::lock_guard<std::mutex> lock(mutex_);
+		bool ok = true;
+		for(Header* h = head_; h; h = h->next) ok &= check_block(h);
+		return ok;
+	}
+
+	//live blocks grouped by tag
+	void dump_live(std::FILE* out = stderr) const{
+		std::vector<AllocationRecord> records;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			records.reserve(live_count_);
+			for(const Header* h = head_; h; h = h->next) records.push_back(h->record);
+			for(const auto& [p, r] : slot_records_) records.push_back(r);
+		}
+		tracking::dump_records(out, tag_, std::move(records));
+	}
+
+	[[nodiscard]] Alloc& inner() noexcept {return inner_;}
+
+private:
+	static constexpr bool kCanFree =
+		tracking::CanFree<Alloc> || tracking::CanFreeSized<Alloc>;
+	static constexpr bool kFixedSlots = utils::FixedSlotPoolLike<Alloc>;
+	static constexpr std::size_t kGuardBytes = 16;
+	static constexpr unsigned char kGuardByte = 0xFD;
+	static constexpr unsigned char kFreedByte = 0xDD;
+
+	struct Header{
+		void* base;
+		std::size_t total;
+		Header* prev;
+		Header* next;
+		AllocationRecord record;
+	};
+	static_assert(kGuardBytes % alignof(Header) == 0);
+
+	static Header* header_of(void* user) noexcept{
+		return reinterpret_cast<Header*>(
+			static_cast<std::byte*>(user) - kGuardBytes - sizeof(Header));
+	}
+
+	static bool guard_intact(const std::byte* p) noexcept{
+		for(std::size_t i = 0; i < kGuardBytes; ++i){
+			if(p[i] != std::byte{kGuardByte}) return false;
+		}
+		return true;
+	}
+
+	bool check_block(const Header* h){
+		auto* user = static_cast<const std::byte*>(h->record.ptr);
+		bool ok = true;
+		if(!guard_intact(user - kGuardBytes)){
+			++corruptions_;
+			handler_(h->record, "underrun");
+			ok = false;
+		}
+		if(!guard_intact(user + h->record.size)){
+			++corruptions_;
+			handler_(h->record, "overrun");
+			ok = false;
+		}
+		return ok;
+	}
+
+	void release(void* p, void*& base, std::size_t& total){
+		Header* h = header_of(p);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			check_block(h);
+			unlink(h);
+		}
+		base = h->base;
+		total = h->total;
+		std::memset(p, kFreedByte, h->record.size);
+	}
+
+	void release_slot(void* p){
+		std::size_t size = 0;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto it = slot_records_.find(p);
+			assert(it != slot_records_.end() && "block not allocated through this tracker");
+			if(it == slot_records_.end()) return;
+			size = it->second.size;
+			slot_records_.erase(it);
+			--live_count_;
+			live_bytes_ -= size;
+		}
+		std::memset(p, kFreedByte, size);
+	}
+
+	void link(Header* h) noexcept{
+		h->prev = nullptr;
+		h->next = head_;
+		if(head_) head_->prev = h;
+		head_ = h;
+		++live_count_;
+		live_bytes_ += h->record.size;
+	}
+
+	void unlink(Header* h) noexcept{
+		if(h->prev) h->prev->next = h->next;
+		else head_ = h->next;
+		if(h->next) h->next->prev = h->prev;
+		--live_count_;
+		live_bytes_ -= h->record.size;
+	}
+
+	Alloc& inner_;
+	const char* tag_ = nullptr;
+	CorruptionHandler handler_ = &tracking::default_corruption_handler;
+
+	mutable std::mutex mutex_;
+	Header* head_ = nullptr;
+	//blocks of a fixed slot pool, keyed by address
+	std::unordered_map<const void*, AllocationRecord> slot_records_;
+	std::size_t live_count_ = 0;
+	std::size_t live_bytes_ = 0;
+	std::size_t corruptions_ = 0;
+};
+
+} // namespace engine::mem::allocator
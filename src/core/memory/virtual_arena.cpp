@@ -0,0 +1,95 @@
+#include<cassert>
+#include<cstdint>
+#include<new>
+
+#include"virtual_arena.hpp"
+#include"virtual_memory.hpp"
+
+namespace engine::mem::allocator{
+
+using engine::mem::os::VirtualMemory;
+
+VirtualArena::VirtualArena(const std::size_t reserve_bytes)
+		: VirtualArena(VirtualArenaDesc{reserve_bytes}){}
+
+VirtualArena::VirtualArena(const VirtualArenaDesc& desc){
+	page_size_ = VirtualMemory::get_page_size();
+	reserved_ = utils::align_up(desc.reserve_bytes, page_size_);
+	commit_step_ = utils::align_up(desc.commit_step ? desc.commit_step : 1, page_size_);
+	decommit_watermark_ = desc.decommit_watermark;
+	numa_policy_ = desc.numa_policy;
+	numa_node_ = desc.numa_node;
+
+	base_ = static_cast<std::byte*>(VirtualMemory::reserve(reserved_));
+	if(!base_){
+		throw std::bad_alloc();
+	}
+}
+
+VirtualArena::~VirtualArena() noexcept{
+	if(base_){
+		VirtualMemory::release(base_, reserved_);
+	}
+}
+
+bool VirtualArena::commit_up_to(std::size_t end_offset) noexcept{
+	const std::size_t committed = committed_.load();
+	if(end_offset <= committed) return true;
+
+	std::size_t target = utils::align_up(end_offset, commit_step_);
+	if(target > reserved_) target = reserved_;
+
+	if(!VirtualMemory::commit(base_ + committed, target - committed,
+			numa_policy_, numa_node_)){
+		return false;
+	}
+	committed_.store(target);
+	return true;
+}
+
+void* VirtualArena::allocate(
+			const std::size_t size,
+			const std::size_t alignment) noexcept{
+	const std::uintptr_t base_addr = reinterpret_cast<std::uintptr_t>(base_);
+	const std::size_t offset = offset_.load();
+	const std::uintptr_t aligned_addr = utils::align_up(base_addr + offset, alignment);
+
+	const std::size_t new_offset = aligned_addr - base_addr + size;
+	if(new_offset > reserved_ || !commit_up_to(new_offset)){
+		return nullptr;
+	}
+
+	offset_.store(new_offset);
+	peak_.raise_to(new_offset);
+	return reinterpret_cast<void*>(aligned_addr);
+}
+
+void VirtualArena::reset() noexcept{
+	offset_.store(0);
+	resets_.add();
+
+	const std::size_t keep = decommit_watermark_ < reserved_
+		? utils::align_up(decommit_watermark_, page_size_)
+		: reserved_;
+	const std::size_t committed = committed_.load();
+	if(committed > keep){
+		VirtualMemory::decommit(base_ + keep, committed - keep);
+		committed_.store(keep);
+	}
+}
+
+void VirtualArena::rollback(const Marker marker) noexcept{
+	assert(marker <= offset_.load() && "marker is newer than the arena top");
+	offset_.store(marker);
+}
+
+ArenaStats VirtualArena::stats() const noexcept{
+	ArenaStats s;
+	s.capacity = reserved_;
+	s.in_use = offset_.load();
+	s.peak = peak_.load();
+	s.resets = resets_.load();
+	return s;
+}
+
+}// namespace engine::mem::allocator
@@ -0,0 +1,75 @@
+#pragma once
+
+#include<limits>
+
+#include"allocator_utils.hpp"
+#include"virtual_memory.hpp"
+#include"allocator_stats.hpp"
+
+namespace engine::mem::allocator{
+
+struct VirtualArenaDesc{
+	//address space reserved up front, costs no RAM
+	std::size_t reserve_bytes = 256 * 1024 * 1024;
+
+	//pages are committed this many bytes at a time as the arena grows,
+	//	rounded up to the page size
+	std::size_t commit_step = 64 * 1024;
+
+	//reset() decommits everything committed above this many bytes
+	//	the default keeps all committed pages for reuse
+	std::size_t decommit_watermark = std::numeric_limits<std::size_t>::max();
+
+	//NUMA placement of committed pages, see PageAllocatorDesc
+	os::NumaPolicy numa_policy = os::NumaPolicy::FirstTouch;
+	int numa_node = 0;
+};
+
+// linear arena over its own reserved range, pages are committed only as
+//	the offset advances, so a generous reservation costs only what is used
+class VirtualArena{
+public:
+	using Marker = std::size_t;
+
+	explicit VirtualArena(const std::size_t reserve_bytes);
+	explicit VirtualArena(const VirtualArenaDesc& desc);
+	~VirtualArena() noexcept;
+
+	VirtualArena(const VirtualArena&) = delete;
+	VirtualArena& operator=(const VirtualArena&) = delete;
+
+	[[nodiscard]] void* allocate(
+			const std::size_t size,
+			const std::size_t alignment = alignof(std::max_align_t)) noexcept;
+	void reset() noexcept;
+
+	[[nodiscard]] Marker get_marker() const noexcept {return offset_.load();}
+	//frees everything allocated after the marker was taken
+	void rollback(const Marker marker) noexcept;
+
+	[[nodiscard]] std::size_t in_use() const {return offset_.load();}
+	[[nodiscard]] std::size_t capacity() const {return reserved_;}
+	[[nodiscard]] std::size_t committed_bytes() const {return committed_.load();}
+
+	//safe to sample from any thread
+	[[nodiscard]] ArenaStats stats() const noexcept;
+
+private:
+	bool commit_up_to(std::size_t end_offset) noexcept;
+
+	std::byte* base_ = nullptr;
+	std::size_t reserved_ = 0;
+	std::size_t page_size_ = 0;
+	std::size_t commit_step_ = 0;
+	std::size_t decommit_watermark_ = 0;
+	os::NumaPolicy numa_policy_ = os::NumaPolicy::FirstTouch;
+	int numa_node_ = 0;
+
+	RelaxedCounter offset_;
+	RelaxedCounter committed_;
+	RelaxedCounter peak_;
+	RelaxedCounter resets_;
+};
+static_assert(utils::MarkerArenaLike<VirtualArena>);
+
+} // namespace engine::mem::allocator
@@ -1,4 +1,5 @@
 #include<cstdlib>
+#include<fstream>
 
 #include"virtual_memory.hpp"
 #include"allocator_utils.hpp"
@@ -11,6 +12,9 @@ using namespace engine::mem;
 	#include<malloc.h>
 #elif defined(__linux__) || defined(__unix__)
 	#include<sys/mman.h>
+	#include<sys/stat.h>
+	#include<sys/syscall.h>
+	#include<fcntl.h>
 	#include<unistd.h>
 	#include<errno.h>
 	#include<stdlib.h>
@@ -29,6 +33,36 @@ std::size_t VirtualMemory::get_page_size(){
 #endif
 }
 
+std::size_t VirtualMemory::get_huge_page_size(){
+#if defined(WIN32) || defined(_WIN64)
+	return static_cast<std::size_t>(GetLargePageMinimum());
+#elif defined(__linux__)
+	std::ifstream meminfo("/proc/meminfo");
+	std::string key;
+	std::size_t kb = 0;
+	while(meminfo >> key){
+		if(key == "Hugepagesize:" && meminfo >> kb) return kb * 1024;
+		meminfo.ignore(256, '\n');
+	}
+	//kernels without hugetlbfs may still back ranges transparently
+	std::ifstream thp("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+	std::size_t bytes = 0;
+	if(thp >> bytes) return bytes;
+	return 0;
+#else
+	return 0;
+#endif
+}
+
+#if defined(__linux__)
+static bool transparent_huge_pages_disabled(){
+	std::ifstream f("/sys/kernel/mm/transparent_hugepage/enabled");
+	std::string modes;
+	std::getline(f, modes);
+	return !f || modes.find("[never]") != std::string::npos;
+}
+#endif
+
 void* VirtualMemory::reserve(std::size_t size){
 #if defined(WIN32) || defined(_WIN64)
 	return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_READWRITE);
@@ -41,6 +75,51 @@ void* VirtualMemory::reserve(std::size_t size){
 #endif
 }
 
+void* VirtualMemory::reserve_huge(std::size_t size, PageBacking& backing){
+	backing = PageBacking::Regular;
+#if defined(__linux__)
+	const std::size_t huge = get_huge_page_size();
+	if(huge == 0) return reserve(size);
+
+	#if defined(MAP_HUGETLB)
+	//fails cleanly when the hugetlb pool cant cover the whole range
+	void* explicit_ptr = mmap(nullptr, size, PROT_NONE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if(explicit_ptr != MAP_FAILED){
+		backing = PageBacking::ExplicitHuge;
+		return explicit_ptr;
+	}
+	#endif
+
+	//over-reserve and trim so the range starts on a huge page boundary
+	void* raw = reserve(size + huge);
+	if(!raw) return nullptr;
+
+	std::uintptr_t raw_addr = reinterpret_cast<std::uintptr_t>(raw);
+	std::uintptr_t aligned_addr = utils::align_up(raw_addr, huge);
+	std::size_t head = aligned_addr - raw_addr;
+	std::size_t tail = huge - head;
+
+	if(head) munmap(raw, head);
+	if(tail) munmap(reinterpret_cast<void*>(aligned_addr + size), tail);
+
+	void* ptr = reinterpret_cast<void*>(aligned_addr);
+
+	#if defined(MADV_HUGEPAGE)
+	if(!transparent_huge_pages_disabled() 
+			&& madvise(ptr, size, MADV_HUGEPAGE) == 0){
+		backing = PageBacking::TransparentHuge;
+	}
+	#endif
+
+	return ptr;
+#else
+	//large pages on windows need SeLockMemoryPrivilege and cant be
+	//reserved without committing, stay on regular pages
+	return reserve(size);
+#endif
+}
+
 bool VirtualMemory::commit(void* ptr, std::size_t size){
 #if defined(WIN32) || defined(_WIN64)
 	void*result = VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE);
@@ -53,6 +132,87 @@ bool VirtualMemory::commit(void* ptr, std::size_t size){
 #endif
 }
 
+#if defined(__linux__)
+//node list like "0-1,4", highest node id + 1 or 0 when unreadable
+static int parse_node_list(const std::string& list){
+	int count = 0;
+	std::size_t pos = 0;
+	while(pos < list.size()){
+		std::size_t end = list.find(',', pos);
+		if(end == std::string::npos) end = list.size();
+		const std::string range = list.substr(pos, end - pos);
+		const std::size_t dash = range.find('-');
+		const int last = std::atoi(range.c_str() + (dash == std::string::npos ? 0 : dash + 1));
+		if(!range.empty() && last + 1 > count) count = last + 1;
+		pos = end + 1;
+	}
+	return count;
+}
+#endif
+
+int VirtualMemory::numa_node_count(){
+#if defined(WIN32) || defined(_WIN64)
+	ULONG highest = 0;
+	return GetNumaHighestNodeNumber(&highest) ? static_cast<int>(highest) + 1 : 1;
+#elif defined(__linux__)
+	static const int count = []{
+		std::ifstream f("/sys/devices/system/node/has_memory");
+		std::string list;
+		std::getline(f, list);
+		const int n = parse_node_list(list);
+		return n > 0 ? n : 1;
+	}();
+	return count;
+#else
+	return 1;
+#endif
+}
+
+int VirtualMemory::current_numa_node(){
+#if defined(WIN32) || defined(_WIN64)
+	PROCESSOR_NUMBER pn;
+	GetCurrentProcessorNumberEx(&pn);
+	USHORT node = 0;
+	return GetNumaProcessorNodeEx(&pn, &node) ? node : 0;
+#elif defined(__linux__) && defined(SYS_getcpu)
+	unsigned cpu = 0;
+	unsigned node = 0;
+	if(syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return 0;
+	return static_cast<int>(node);
+#else
+	return 0;
+#endif
+}
+
+bool VirtualMemory::commit(void* ptr, std::size_t size,
+		NumaPolicy policy, int node){
+	if(policy == NumaPolicy::FirstTouch || numa_node_count() <= 1){
+		return commit(ptr, size);
+	}
+	if(policy == NumaPolicy::Local) node = current_numa_node();
+	if(node < 0 || node >= numa_node_count()) return commit(ptr, size);
+
+#if defined(WIN32) || defined(_WIN64)
+	void*result = VirtualAllocExNuma(GetCurrentProcess(), ptr, size,
+			MEM_COMMIT, PAGE_READWRITE, static_cast<DWORD>(node));
+	return result != nullptr;
+#elif defined(__linux__) && defined(SYS_mbind)
+	//preferred rather than bound, a full node spills instead of failing
+	constexpr int kMpolPreferred = 1;
+	constexpr std::size_t kMaskBits = 1024;
+	unsigned long mask[kMaskBits / (8 * sizeof(unsigned long))] = {};
+	const auto bit = static_cast<std::size_t>(node);
+	if(bit >= kMaskBits) return commit(ptr, size);
+	mask[bit / (8 * sizeof(unsigned long))] |= 1ul << (bit % (8 * sizeof(unsigned long)));
+
+	//placement is a hint, commit anyway if the kernel refuses it
+	(void)syscall(SYS_mbind, ptr, size, kMpolPreferred, mask, kMaskBits, 0u);
+	return commit(ptr, size);
+#else
+	return commit(ptr, size);
+#endif
+}
+
 void VirtualMemory::decommit(void* ptr, std::size_t size){
 #if defined(WIN32) || defined(_WIN64)
 	VirtualFree(ptr, size, MEM_DECOMMIT);
@@ -62,6 +222,56 @@ void VirtualMemory::decommit(void* ptr, std::size_t size){
 #endif
 }
 
+void VirtualMemory::guard(void* ptr, std::size_t size){
+#if defined(WIN32) || defined(_WIN64)
+	//PAGE_GUARD fires only once, a decommitted page faults every time
+	VirtualFree(ptr, size, MEM_DECOMMIT);
+#elif defined(__linux__) || defined(__unix__)
+	mprotect(ptr, size, PROT_NONE);
+	madvise(ptr, size, MADV_DONTNEED);
+#endif
+}
+
+void VirtualMemory::purge(void* ptr, std::size_t size){
+#if defined(WIN32) || defined(_WIN64)
+	VirtualAlloc(ptr, size, MEM_RESET, PAGE_READWRITE);
+#elif defined(__linux__) || defined(__unix__)
+	madvise(ptr, size, MADV_DONTNEED);
+#endif
+}
+
+void VirtualMemory::prefault(void* ptr, std::size_t size, PrefaultMode mode){
+	if(mode == PrefaultMode::None || size == 0) return;
+
+	if(mode == PrefaultMode::Touch){
+		const std::size_t page = get_page_size();
+		auto* bytes = static_cast<volatile char*>(ptr);
+		for(std::size_t i = 0; i < size; i += page) bytes[i] = 0;
+		return;
+	}
+#if defined(WIN32) || defined(_WIN64)
+	WIN32_MEMORY_RANGE_ENTRY range{ptr, size};
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#elif defined(__linux__)
+	#if defined(MADV_POPULATE_WRITE)
+	if(madvise(ptr, size, MADV_POPULATE_WRITE) == 0) return;
+	#endif
+	//older kernels, only a hint
+	madvise(ptr, size, MADV_WILLNEED);
+#endif
+}
+
+void VirtualMemory::reclaim(void* ptr, std::size_t size, ReclaimMode mode){
+	if(mode == ReclaimMode::Decommit){
+		decommit(ptr, size);
+		return;
+	}
+#if defined(__linux__) && defined(MADV_FREE)
+	if(madvise(ptr, size, MADV_FREE) == 0) return;
+#endif
+	purge(ptr, size);
+}
+
 void VirtualMemory::release(void* ptr, std::size_t size){
 #if defined(WIN32) || defined(_WIN64)
 	(void)size;
@@ -95,6 +305,88 @@ void VirtualMemory::os_aligned_free(void*p) {
 #endif
 }
 
+void* VirtualMemory::map_file(const char* path, MapMode mode,
+		std::size_t& size){
+	size = 0;
+#if defined(WIN32) || defined(_WIN64)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE) return nullptr;
+
+	LARGE_INTEGER file_size{};
+	if(!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0){
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	const bool cow = mode == MapMode::CopyOnWrite;
+	HANDLE mapping = CreateFileMappingA(file, nullptr,
+			cow ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if(!mapping) return nullptr;
+
+	//the view keeps the mapping object alive
+	void* ptr = MapViewOfFile(mapping, cow ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(ptr) size = static_cast<std::size_t>(file_size.QuadPart);
+	return ptr;
+#elif defined(__linux__) || defined(__unix__)
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if(fd < 0) return nullptr;
+
+	struct stat st{};
+	if(fstat(fd, &st) != 0 || st.st_size <= 0){
+		close(fd);
+		return nullptr;
+	}
+
+	const auto file_size = static_cast<std::size_t>(st.st_size);
+	void* ptr = mode == MapMode::CopyOnWrite
+		? mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)
+		: mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+	//the mapping holds its own reference to the file
+	close(fd);
+	if(ptr == MAP_FAILED) return nullptr;
+
+	size = file_size;
+	return ptr;
+#else
+	(void)path;
+	(void)mode;
+	return nullptr;
+#endif
+}
+
+void VirtualMemory::unmap_file(void* ptr, std::size_t size){
+	if(!ptr) return;
+#if defined(WIN32) || defined(_WIN64)
+	(void)size;
+	UnmapViewOfFile(ptr);
+#elif defined(__linux__) || defined(__unix__)
+	munmap(ptr, size);
+#endif
+}
+
+void VirtualMemory::advise(void* ptr, std::size_t size, AccessHint hint){
+	if(!ptr || size == 0) return;
+#if defined(WIN32) || defined(_WIN64)
+	//only prefetching has a windows counterpart
+	if(hint == AccessHint::WillNeed){
+		WIN32_MEMORY_RANGE_ENTRY range{ptr, size};
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+#elif defined(__linux__) || defined(__unix__)
+	int advice = MADV_NORMAL;
+	switch(hint){
+		case AccessHint::Normal: advice = MADV_NORMAL; break;
+		case AccessHint::Sequential: advice = MADV_SEQUENTIAL; break;
+		case AccessHint::Random: advice = MADV_RANDOM; break;
+		case AccessHint::WillNeed: advice = MADV_WILLNEED; break;
+	}
+	madvise(ptr, size, advice);
+#endif
+}
+
 std::string VirtualMemory::detected_os(){
 #if defined(WIN32) || defined(_WIN64)
 		return "win";
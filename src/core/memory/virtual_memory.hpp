@@ -5,20 +5,100 @@
 
 namespace engine::mem::os{
 
+//what actually backs a reservation
+enum class PageBacking{
+	Regular,
+	TransparentHuge,	//THP requested via madvise, kernel promotes on fault
+	ExplicitHuge		//MAP_HUGETLB pages from the preallocated pool
+};
+
+//where committed pages are placed on NUMA machines
+enum class NumaPolicy{
+	FirstTouch,	//OS default, the first thread touching a page decides
+	Node,		//prefer a fixed node
+	Local		//prefer the node of the thread committing the pages
+};
+
+//how pages handed back to the OS are released
+enum class ReclaimMode{
+	Decommit,	//drop the pages and remove access, same as decommit()
+	LazyFree	//MADV_FREE, the kernel takes the pages only under memory
+				//	pressure, the range stays accessible and a write keeps a page
+};
+
+//how committed pages get physical backing before their first use
+enum class PrefaultMode{
+	None,		//fault on first touch
+	Populate,	//MADV_POPULATE_WRITE, contents untouched, WILLNEED where missing
+	Touch		//write a zero to every page, only for pages nobody wrote yet
+};
+
+//how a mapped file may be accessed
+enum class MapMode{
+	ReadOnly,		//shared with the page cache, writes fault
+	CopyOnWrite		//writable, written pages become private, the file is untouched
+};
+
+//expected access pattern of a mapped range, a hint only
+enum class AccessHint{
+	Normal,
+	Sequential,	//aggressive read ahead, pages behind can go early
+	Random,		//no read ahead
+	WillNeed	//start reading the whole range in now
+};
+
 struct VirtualMemory{
 	[[nodiscard]] static std::size_t get_page_size();
 
+	//default huge page size (2 MiB on x86_64), 0 if the OS reports none
+	[[nodiscard]] static std::size_t get_huge_page_size();
+
 	//reserve virtual mem
 	[[nodiscard]] static void*reserve(std::size_t size);
 
+	//reserve virtual mem aligned to huge page size
+	//	tries explicit huge pages first, then transparent ones,
+	//	then falls back to regular pages
+	//	size must be divisable by huge page size
+	[[nodiscard]] static void*reserve_huge(std::size_t size, PageBacking& backing);
+
 	//commit RAM under reserved addr
 	//	ptr must be a result of reserve function
 	//	size must be divisable by pagesize
 	[[nodiscard]] static bool commit(void*ptr, std::size_t size);
 
+	//commit and place the pages per policy, node is used by Node only
+	//	same as plain commit on single node machines or for FirstTouch
+	[[nodiscard]] static bool commit(void*ptr, std::size_t size,
+			NumaPolicy policy, int node = 0);
+
+	//NUMA nodes with memory, 1 on non-NUMA machines
+	[[nodiscard]] static int numa_node_count();
+
+	//node of the cpu the calling thread runs on, 0 if unknown
+	[[nodiscard]] static int current_numa_node();
+
 	//decommit RAM (back to system), ptr addr is still reserved
 	static void decommit(void* ptr, std::size_t size);
 
+	//turn committed pages into guard pages, any access faults
+	//	they cost no RAM, commit() makes them usable again
+	//	ptr and size must be page aligned
+	static void guard(void* ptr, std::size_t size);
+
+	//drop the physical pages but keep the range committed
+	//	contents are lost, the next touch faults in zeroed pages
+	//	ptr and size must be page aligned
+	static void purge(void* ptr, std::size_t size);
+
+	//fault the committed range in now instead of on first use
+	//	ptr and size must be page aligned
+	static void prefault(void* ptr, std::size_t size, PrefaultMode mode);
+
+	//give the pages back per mode, ptr and size must be page aligned
+	//	LazyFree falls back to purge() where MADV_FREE is missing
+	static void reclaim(void* ptr, std::size_t size, ReclaimMode mode);
+
 	//release memory 
 	//	ptr must be a result of reserve function
 	//	size arg is needed only on linux
@@ -28,6 +108,17 @@ struct VirtualMemory{
 
 	static void os_aligned_free(void*p);
 
+	//map a whole file, nullptr if it cant be opened or is empty
+	//	size receives the file size, the mapping outlives the handle
+	[[nodiscard]] static void* map_file(const char* path, MapMode mode,
+			std::size_t& size);
+
+	//ptr and size as returned by map_file
+	static void unmap_file(void* ptr, std::size_t size);
+
+	//ptr must be page aligned
+	static void advise(void* ptr, std::size_t size, AccessHint hint);
+
 	[[nodiscard]] static std::string detected_os();
 };
 
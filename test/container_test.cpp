@@ -0,0 +1,398 @@
+#include<cstdint>
+#include<string>
+#include<unordered_map>
+#include<vector>
+
+#include<core/containers/dynamic_array.hpp>
+#include<core/containers/small_vector.hpp>
+#include<core/containers/fixed_array.hpp>
+#include<core/containers/hash_map.hpp>
+#include<core/containers/slot_map.hpp>
+#include<core/memory/default_heap.hpp>
+#include<core/memory/linear_arena.hpp>
+#include<core/memory/page_allocator.hpp>
+#include<core/memory/pool_allocator.hpp>
+#include<core/memory/static_allocator_ref.hpp>
+
+#include<gtest/gtest.h>
+
+using namespace engine::containers;
+using namespace engine::mem::allocator;
+
+namespace{
+
+struct Tracked{
+	static inline int live = 0;
+	int v = 0;
+
+	Tracked(int x = 0) noexcept : v(x) {++live;}
+	Tracked(const Tracked& o) noexcept : v(o.v) {++live;}
+	Tracked(Tracked&& o) noexcept : v(o.v) {o.v = -1; ++live;}
+	Tracked& operator=(const Tracked&) noexcept = default;
+	Tracked& operator=(Tracked&&) noexcept = default;
+	~Tracked() {--live;}
+};
+
+} // namespace
+
+TEST(DynamicArrayTest, GrowsAndKeepsElements){
+	DefaultHeap heap;
+	DynamicArray<int> arr(AllocatorHandle::from_heap(heap));
+
+	for(int i = 0; i < 1000; ++i) ASSERT_TRUE(arr.push_back(i));
+	EXPECT_EQ(arr.size(), 1000u);
+	EXPECT_GE(arr.capacity(), 1000u);
+	for(int i = 0; i < 1000; ++i) EXPECT_EQ(arr[static_cast<std::size_t>(i)], i);
+
+	arr.erase_swap(0);
+	EXPECT_EQ(arr[0], 999);
+	arr.pop_back();
+	EXPECT_EQ(arr.size(), 998u);
+
+	int sum = 0;
+	for(int v : arr) sum += v;
+	EXPECT_GT(sum, 0);
+}
+
+TEST(DynamicArrayTest, RelocatesNonTrivialTypes){
+	Tracked::live = 0;
+	{
+		DefaultHeap heap;
+		DynamicArray<Tracked> arr(AllocatorHandle::from_heap(heap));
+		for(int i = 0; i < 100; ++i) ASSERT_NE(arr.emplace_back(i), nullptr);
+		EXPECT_EQ(Tracked::live, 100);
+		EXPECT_EQ(arr[57].v, 57);
+
+		DynamicArray<Tracked> moved(std::move(arr));
+		EXPECT_EQ(arr.size(), 0u);
+		EXPECT_EQ(moved.size(), 100u);
+		ASSERT_TRUE(moved.resize(10));
+		EXPECT_EQ(Tracked::live, 10);
+	}
+	EXPECT_EQ(Tracked::live, 0);
+
+	static_assert(is_trivially_relocatable_v<int>);
+	static_assert(!is_trivially_relocatable_v<std::string>);
+}
+
+TEST(DynamicArrayTest, ReportsOutOfMemory){
+	PageAllocator backing;
+	backing.init(64 * 1024);
+	LinearArena arena(backing, 1024);
+	DynamicArray<std::uint64_t, StaticAllocatorRef<LinearArena>> arr{StaticAllocatorRef(arena)};
+
+	bool ok = true;
+	std::size_t pushed = 0;
+	while(ok && pushed < 1000){
+		ok = arr.push_back(pushed);
+		if(ok) ++pushed;
+	}
+	EXPECT_FALSE(ok);
+	EXPECT_LT(pushed, 128u);
+	EXPECT_EQ(arr.size(), pushed);
+	EXPECT_EQ(arr.back(), pushed - 1);
+}
+
+TEST(SmallVectorTest, StaysInlineThenSpills){
+	DefaultHeap heap;
+	SmallVector<int, 4> v(AllocatorHandle::from_heap(heap));
+
+	for(int i = 0; i < 4; ++i) ASSERT_TRUE(v.push_back(i));
+	EXPECT_TRUE(v.is_inline());
+	EXPECT_EQ(heap.allocs_, 0u);
+
+	ASSERT_TRUE(v.push_back(4));
+	EXPECT_FALSE(v.is_inline());
+	EXPECT_EQ(heap.allocs_, 1u);
+	for(int i = 0; i < 5; ++i) EXPECT_EQ(v[static_cast<std::size_t>(i)], i);
+}
+
+TEST(SmallVectorTest, MovesInlineAndHeapStorage){
+	Tracked::live = 0;
+	{
+		DefaultHeap heap;
+		SmallVector<Tracked, 2> small(AllocatorHandle::from_heap(heap));
+		small.emplace_back(1);
+		SmallVector<Tracked, 2> a(std::move(small));
+		EXPECT_TRUE(a.is_inline());
+		EXPECT_EQ(a[0].v, 1);
+		EXPECT_EQ(small.size(), 0u);
+
+		SmallVector<Tracked, 2> big(AllocatorHandle::from_heap(heap));
+		for(int i = 0; i < 8; ++i) big.emplace_back(i);
+		const Tracked* heap_data = big.data();
+		a = std::move(big);
+		EXPECT_EQ(a.data(), heap_data);
+		EXPECT_EQ(a.size(), 8u);
+		EXPECT_TRUE(big.is_inline());
+		EXPECT_EQ(Tracked::live, 8);
+	}
+	EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST(DynamicArrayTest, PushBackOfOwnElementSurvivesGrowth){
+	DefaultHeap heap;
+	DynamicArray<int> a(AllocatorHandle::from_heap(heap));
+	for(int i = 0; i < 8; ++i) ASSERT_TRUE(a.push_back(i + 10));
+	ASSERT_EQ(a.size(), a.capacity());
+
+	ASSERT_TRUE(a.push_back(a[0]));
+	EXPECT_EQ(a[8], 10);
+
+	DynamicArray<Tracked> t(AllocatorHandle::from_heap(heap));
+	for(int i = 0; i < 8; ++i) ASSERT_NE(t.emplace_back(i + 10), nullptr);
+	ASSERT_TRUE(t.push_back(t[7]));
+	EXPECT_EQ(t[8].v, 17);
+}
+
+TEST(SmallVectorTest, PushBackOfOwnElementSurvivesGrowth){
+	DefaultHeap heap;
+	SmallVector<int, 4> v(AllocatorHandle::from_heap(heap));
+	for(int i = 0; i < 4; ++i) ASSERT_TRUE(v.push_back(i + 10));
+
+	// inline to heap, then heap to a bigger heap block
+	ASSERT_TRUE(v.push_back(v[0]));
+	for(int i = 0; i < 3; ++i) ASSERT_TRUE(v.push_back(i));
+	ASSERT_EQ(v.size(), v.capacity());
+	ASSERT_TRUE(v.push_back(v[1]));
+	EXPECT_EQ(v[4], 10);
+	EXPECT_EQ(v[8], 11);
+}
+
+TEST(FixedArrayTest, HoldsUpToCapacity){
+	FixedArray<Tracked, 3> arr;
+	EXPECT_TRUE(arr.push_back(Tracked{1}));
+	EXPECT_TRUE(arr.push_back(Tracked{2}));
+	EXPECT_NE(arr.emplace_back(3), nullptr);
+	EXPECT_TRUE(arr.full());
+	EXPECT_EQ(arr.emplace_back(4), nullptr);
+
+	FixedArray<Tracked, 3> copy(arr);
+	arr.erase_swap(0);
+	EXPECT_EQ(arr[0].v, 3);
+	EXPECT_EQ(copy[0].v, 1);
+	EXPECT_EQ(copy.size(), 3u);
+}
+
+TEST(HashMapTest, InsertFindErase){
+	DefaultHeap heap;
+	HashMap<int, std::string> map(AllocatorHandle::from_heap(heap));
+
+	auto [v, inserted] = map.try_emplace(7, "seven");
+	ASSERT_NE(v, nullptr);
+	EXPECT_TRUE(inserted);
+	EXPECT_FALSE(map.try_emplace(7, "again").second);
+	EXPECT_EQ(*map.find(7), "seven");
+
+	map.insert_or_assign(7, "SEVEN");
+	EXPECT_EQ(*map.find(7), "SEVEN");
+	EXPECT_EQ(map.find(8), nullptr);
+
+	EXPECT_TRUE(map.erase(7));
+	EXPECT_FALSE(map.erase(7));
+	EXPECT_TRUE(map.empty());
+}
+
+TEST(HashMapTest, MatchesStdUnorderedMapUnderChurn){
+	DefaultHeap heap;
+	HashMap<std::uint32_t, std::uint32_t> map(AllocatorHandle::from_heap(heap));
+	std::unordered_map<std::uint32_t, std::uint32_t> ref;
+
+	std::uint32_t rng = 1;
+	for(int i = 0; i < 50000; ++i){
+		rng = rng * 1664525u + 1013904223u;
+		const std::uint32_t key = (rng >> 8) % 4096;
+		if(rng & 1){
+			map.insert_or_assign(key, static_cast<std::uint32_t>(i));
+			ref[key] = static_cast<std::uint32_t>(i);
+		}
+		else{
+			EXPECT_EQ(map.erase(key), ref.erase(key) == 1);
+		}
+	}
+
+	ASSERT_EQ(map.size(), ref.size());
+	for(const auto& [k, val] : ref){
+		const std::uint32_t* found = map.find(k);
+		ASSERT_NE(found, nullptr);
+		EXPECT_EQ(*found, val);
+	}
+
+	std::size_t visited = 0;
+	for(const auto& e : map){
+		EXPECT_EQ(ref.at(e.key), e.value);
+		++visited;
+	}
+	EXPECT_EQ(visited, ref.size());
+}
+
+TEST(HashMapTest, LivesOnAnArena){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+	LinearArena arena(backing, 512 * 1024);
+	HashMap<int, int> map(AllocatorHandle::from_arena(arena));
+
+	ASSERT_TRUE(map.reserve(1000));
+	const std::size_t used = arena.in_use();
+	for(int i = 0; i < 1000; ++i) ASSERT_NE(map.try_emplace(i, i * 2).first, nullptr);
+	EXPECT_EQ(arena.in_use(), used);
+	EXPECT_EQ(*map.find(999), 1998);
+}
+
+TEST(HashMapTest, TombstoneChurnDoesNotGrowTable){
+	DefaultHeap heap;
+	HashMap<std::uint64_t, int> map(AllocatorHandle::from_heap(heap));
+
+	for(std::uint64_t k = 0; k < 100; ++k) map.try_emplace(k, 0);
+	const std::size_t cap = map.capacity();
+
+	// a sliding window of 100 live keys, every step erases one and adds one
+	for(std::uint64_t k = 100; k < 100000; ++k){
+		ASSERT_TRUE(map.erase(k - 100));
+		ASSERT_TRUE(map.try_emplace(k, 1).second);
+	}
+	EXPECT_EQ(map.size(), 100u);
+	EXPECT_LE(map.capacity(), cap * 2);
+	for(std::uint64_t k = 99900; k < 100000; ++k) EXPECT_TRUE(map.contains(k));
+	EXPECT_FALSE(map.contains(99899));
+
+	// tombstones are dropped in place, an arena never sees another table
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+	LinearArena arena(backing, 64 * 1024);
+	HashMap<std::uint64_t, std::string> arena_map(AllocatorHandle::from_arena(arena));
+	// live keys stay under half the load, so only tombstones get dropped
+	ASSERT_TRUE(arena_map.reserve(300));
+	const std::size_t used = arena.in_use();
+	for(std::uint64_t k = 0; k < 100000; ++k){
+		if(k >= 100){
+			ASSERT_TRUE(arena_map.erase(k - 100));
+		}
+		ASSERT_TRUE(arena_map.try_emplace(k, std::to_string(k)).second);
+	}
+	EXPECT_EQ(arena.in_use(), used);
+	EXPECT_EQ(arena_map.size(), 100u);
+	for(std::uint64_t k = 99900; k < 100000; ++k){
+		ASSERT_NE(arena_map.find(k), nullptr);
+		EXPECT_EQ(*arena_map.find(k), std::to_string(k));
+	}
+}
+
+TEST(HashMapTest, CollidingHashesStillResolve){
+	struct BadHash{
+		std::size_t operator()(int) const noexcept {return 42;}
+	};
+	DefaultHeap heap;
+	HashMap<int, int, BadHash> map(AllocatorHandle::from_heap(heap));
+
+	for(int i = 0; i < 200; ++i) ASSERT_TRUE(map.try_emplace(i, i).second);
+	for(int i = 0; i < 200; i += 2) ASSERT_TRUE(map.erase(i));
+	for(int i = 0; i < 200; ++i) EXPECT_EQ(map.contains(i), i % 2 == 1);
+}
+
+TEST(SlotMapTest, HandlesResolveUntilErased){
+	DefaultHeap heap;
+	SlotMap<Tracked> map(AllocatorHandle::from_heap(heap));
+	Tracked::live = 0;
+
+	auto a = map.emplace(1);
+	auto b = map.emplace(2);
+	auto c = map.emplace(3);
+	ASSERT_TRUE(a.valid() && b.valid() && c.valid());
+	EXPECT_EQ(map.get(b)->v, 2);
+
+	// the last element moves into the hole, its handle still resolves
+	EXPECT_TRUE(map.erase(a));
+	EXPECT_FALSE(map.erase(a));
+	EXPECT_EQ(map.get(a), nullptr);
+	EXPECT_EQ(map.get(c)->v, 3);
+	EXPECT_EQ(map.size(), 2u);
+	EXPECT_EQ(map.begin()->v, 3);
+	EXPECT_EQ(map.handle_at(0), c);
+
+	// the freed slot is reused under a new generation
+	auto d = map.emplace(4);
+	EXPECT_EQ(d.index(), a.index());
+	EXPECT_NE(d, a);
+	EXPECT_EQ(map.get(a), nullptr);
+	EXPECT_EQ(map.get(d)->v, 4);
+	EXPECT_EQ(map.slot_count(), 3u);
+
+	map.clear();
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(Tracked::live, 0);
+	EXPECT_FALSE(map.contains(b));
+}
+
+TEST(SlotMapTest, MatchesReferenceUnderChurn){
+	DefaultHeap heap;
+	SlotMap<std::uint64_t> map(AllocatorHandle::from_heap(heap));
+	std::vector<std::pair<SlotMap<std::uint64_t>::Handle, std::uint64_t>> live;
+	std::vector<SlotMap<std::uint64_t>::Handle> dead;
+
+	std::uint64_t x = 7;
+	for(int i = 0; i < 20000; ++i){
+		x = x * 6364136223846793005ull + 1442695040888963407ull;
+		if(live.empty() || (x >> 33) % 3 != 0){
+			auto h = map.insert(x);
+			ASSERT_TRUE(h.valid());
+			live.emplace_back(h, x);
+		}
+		else{
+			const std::size_t at = (x >> 40) % live.size();
+			ASSERT_TRUE(map.erase(live[at].first));
+			dead.push_back(live[at].first);
+			live[at] = live.back();
+			live.pop_back();
+		}
+	}
+
+	ASSERT_EQ(map.size(), live.size());
+	for(auto& [h, v] : live) ASSERT_EQ(*map.get(h), v);
+	for(auto h : dead) ASSERT_FALSE(map.contains(h));
+	EXPECT_LE(map.slot_count(), live.size() + dead.size());
+}
+
+TEST(SlotMapTest, MovedFromMapIsReusable){
+	DefaultHeap heap;
+	SlotMap<int> map(AllocatorHandle::from_heap(heap));
+
+	auto a = map.emplace(1);
+	map.emplace(2);
+	ASSERT_TRUE(map.erase(a));
+
+	// the source had a free slot queued, it must not carry over
+	SlotMap<int> moved(std::move(map));
+	EXPECT_EQ(moved.size(), 1u);
+	auto h = map.emplace(3);
+	ASSERT_TRUE(h.valid());
+	EXPECT_EQ(*map.get(h), 3);
+	EXPECT_EQ(map.slot_count(), 1u);
+
+	SlotMap<int> assigned(AllocatorHandle::from_heap(heap));
+	assigned = std::move(moved);
+	auto g = moved.emplace(4);
+	ASSERT_TRUE(g.valid());
+	EXPECT_EQ(*moved.get(g), 4);
+	EXPECT_EQ(moved.slot_count(), 1u);
+
+	// the destination picks up the free list
+	auto r = assigned.emplace(5);
+	EXPECT_EQ(r.index(), a.index());
+	EXPECT_EQ(assigned.size(), 2u);
+}
+
+TEST(SlotMapTest, RetiresSlotsWhenGenerationsRunOut){
+	DefaultHeap heap;
+	// 4 generation bits
+	SlotMap<int, 28> map(AllocatorHandle::from_heap(heap));
+
+	auto first = map.emplace(0);
+	for(int i = 0; i < 20; ++i){
+		auto h = map.emplace(i);
+		ASSERT_TRUE(map.erase(h));
+	}
+	EXPECT_TRUE(map.contains(first));
+	// one slot is exhausted and a fresh one took over
+	EXPECT_EQ(map.slot_count(), 3u);
+}
@@ -1,13 +1,36 @@
+#include<cstdio>
 #include<cstring>
+#include<filesystem>
+#include<fstream>
+#include<string>
+#include<memory_resource>
 #include<vector>
 #include<algorithm>
+#include<atomic>
+#include<thread>
 #include<gtest/gtest.h>
 
 #include<core/memory/default_heap.hpp>
 #include<core/memory/linear_arena.hpp>
+#include<core/memory/double_ended_arena.hpp>
+#include<core/memory/frame_arena.hpp>
+#include<core/memory/virtual_arena.hpp>
+#include<core/memory/scratch_arena.hpp>
+#include<core/memory/arena_scope.hpp>
 #include<core/memory/pool_allocator.hpp>
+#include<core/memory/concurrent_pool_allocator.hpp>
+#include<core/memory/growing_pool_allocator.hpp>
+#include<core/memory/small_object_allocator.hpp>
+#include<core/memory/tlsf_allocator.hpp>
 #include<core/memory/page_allocator.hpp>
+#include<core/memory/page_worker.hpp>
 #include<core/memory/allocator_handle.hpp>
+#include<core/memory/static_allocator_ref.hpp>
+#include<core/memory/memory_resource.hpp>
+#include<core/memory/tracking_allocator.hpp>
+#include<core/memory/memory_budget.hpp>
+#include<core/memory/mapped_file.hpp>
+#include<core/memory/fiber_stack.hpp>
 
 #include<gtest/gtest.h>
 
@@ -86,6 +109,66 @@ TEST(LinearArenaTest, LinearArenaWithHeap){
 	EXPECT_EQ(heap.allocs_, 1);
 }
 
+TEST(LinearArenaTest, StatsTrackPeakAndResets){
+	PageAllocator backing;
+	backing.init(4096);
+
+	LinearArena arena(backing, 1024);
+	ASSERT_NE(arena.allocate(100, 1), nullptr);
+	ASSERT_NE(arena.allocate(200, 1), nullptr);
+	arena.reset();
+	ASSERT_NE(arena.allocate(50, 1), nullptr);
+
+	ArenaStats s = arena.stats();
+	EXPECT_EQ(s.capacity, 1024u);
+	EXPECT_EQ(s.in_use, 50u);
+	EXPECT_EQ(s.peak, 300u);
+	EXPECT_EQ(s.resets, 1u);
+}
+
+TEST(LinearArenaTest, RollbackToMarker){
+	PageAllocator backing;
+	backing.init(4096);
+	LinearArena arena(backing, 1024);
+
+	ASSERT_NE(arena.allocate(100, 1), nullptr);
+	const LinearArena::Marker m = arena.get_marker();
+	void*scratch = arena.allocate(300, 1);
+	ASSERT_NE(scratch, nullptr);
+	EXPECT_EQ(arena.in_use(), 400u);
+
+	arena.rollback(m);
+	EXPECT_EQ(arena.in_use(), 100u);
+	EXPECT_EQ(arena.allocate(300, 1), scratch);
+	EXPECT_EQ(arena.stats().peak, 400u);
+}
+
+TEST(LinearArenaTest, NestedScopesUnwindInOrder){
+	PageAllocator backing;
+	backing.init(4096);
+	LinearArena arena(backing, 1024);
+
+	ASSERT_NE(arena.allocate(64, 16), nullptr);
+	{
+		ArenaScope outer(arena);
+		ASSERT_NE(outer.allocate(128, 16), nullptr);
+		{
+			ArenaScope inner(arena);
+			ASSERT_NE(inner.allocate(256, 16), nullptr);
+			EXPECT_EQ(arena.in_use(), 448u);
+		}
+		EXPECT_EQ(arena.in_use(), 192u);
+		{
+			// sibling scope reuses the space the first inner one gave back
+			ArenaScope inner(arena);
+			ASSERT_NE(inner.allocate(256, 16), nullptr);
+			EXPECT_EQ(arena.in_use(), 448u);
+		}
+	}
+	EXPECT_EQ(arena.in_use(), 64u);
+	EXPECT_EQ(arena.stats().peak, 448u);
+}
+
 TEST(LinearArenaTest, RespectsAlignment){
 	PageAllocator backing;
 	backing.init(4096);
@@ -157,6 +240,294 @@ TEST(LinearArenaTest, ExactCapacityUsage){
 	EXPECT_EQ(p2,nullptr);
 }
 
+TEST(DoubleEndedArenaTest, EndsGrowTowardsEachOther){
+	PageAllocator backing;
+	backing.init(4096);
+	DoubleEndedArena arena(backing, 1024);
+
+	auto* low = static_cast<std::byte*>(arena.allocate_bottom(100, 1));
+	auto* high = static_cast<std::byte*>(arena.allocate_top(200, 1));
+	ASSERT_NE(low, nullptr);
+	ASSERT_NE(high, nullptr);
+	EXPECT_LT(low, high);
+	EXPECT_EQ(high + 200, low + 1024);
+
+	EXPECT_EQ(arena.bottom_in_use(), 100u);
+	EXPECT_EQ(arena.top_in_use(), 200u);
+	EXPECT_EQ(arena.in_use(), 300u);
+
+	arena.reset_top();
+	EXPECT_EQ(arena.in_use(), 100u);
+	EXPECT_EQ(arena.allocate_top(200, 1), high);
+}
+
+TEST(DoubleEndedArenaTest, ReturnsNullWhenEndsMeet){
+	PageAllocator backing;
+	backing.init(4096);
+	DoubleEndedArena arena(backing, 1024);
+
+	ASSERT_NE(arena.allocate_bottom(600, 1), nullptr);
+	EXPECT_EQ(arena.allocate_top(500, 1), nullptr);
+	ASSERT_NE(arena.allocate_top(424, 1), nullptr);
+	EXPECT_EQ(arena.in_use(), 1024u);
+	EXPECT_EQ(arena.allocate_bottom(1, 1), nullptr);
+	EXPECT_EQ(arena.allocate_top(1, 1), nullptr);
+
+	arena.reset();
+	EXPECT_EQ(arena.in_use(), 0u);
+	EXPECT_EQ(arena.stats().peak, 1024u);
+}
+
+TEST(DoubleEndedArenaTest, TopRespectsAlignment){
+	PageAllocator backing;
+	backing.init(4096);
+	DoubleEndedArena arena(backing, 1024);
+
+	for(std::size_t al : {1u, 8u, 16u, 64u}){
+		void*p = arena.allocate_top(3, al);
+		ASSERT_NE(p, nullptr);
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % al, 0u);
+	}
+}
+
+TEST(DoubleEndedArenaTest, MarkersAndHandles){
+	PageAllocator backing;
+	backing.init(4096);
+	DoubleEndedArena arena(backing, 1024);
+	auto level = AllocatorHandle::from_arena_bottom(arena);
+	auto decode = AllocatorHandle::from_arena_top(arena);
+
+	ASSERT_NE(level.allocate(64, 16), nullptr);
+	const auto top = arena.get_top_marker();
+	ASSERT_NE(decode.allocate(256, 16), nullptr);
+	{
+		ArenaScope scope(arena);
+		ASSERT_NE(scope.allocate(128, 16), nullptr);
+		EXPECT_EQ(arena.bottom_in_use(), 192u);
+	}
+	EXPECT_EQ(arena.bottom_in_use(), 64u);
+
+	arena.rollback_top(top);
+	EXPECT_EQ(arena.top_in_use(), 0u);
+
+	ASSERT_NE(decode.allocate(256, 16), nullptr);
+	decode.reset();
+	EXPECT_EQ(arena.top_in_use(), 0u);
+	EXPECT_EQ(arena.bottom_in_use(), 64u);
+	EXPECT_EQ(arena.stats().resets, 1u);
+
+	// the bottom handle leaves live top data alone
+	ASSERT_NE(decode.allocate(256, 16), nullptr);
+	level.reset();
+	EXPECT_EQ(arena.bottom_in_use(), 0u);
+	EXPECT_EQ(arena.top_in_use(), 256u);
+	EXPECT_EQ(arena.stats().resets, 2u);
+
+	// a plain arena handle clears both ends
+	AllocatorHandle::from_arena(arena).reset();
+	EXPECT_EQ(arena.in_use(), 0u);
+	EXPECT_EQ(arena.stats().resets, 3u);
+}
+
+TEST(VirtualArenaTest, CommitsOnDemand){
+	VirtualArenaDesc desc;
+	desc.reserve_bytes = 256 * 1024 * 1024;
+	desc.commit_step = 64 * 1024;
+	VirtualArena arena(desc);
+
+	EXPECT_EQ(arena.committed_bytes(), 0u);
+	EXPECT_GE(arena.capacity(), 256u * 1024 * 1024);
+
+	auto* p = static_cast<unsigned char*>(arena.allocate(100, 16));
+	ASSERT_NE(p, nullptr);
+	p[99] = 1;
+	EXPECT_EQ(arena.committed_bytes(), 64u * 1024);
+
+	auto* big = static_cast<unsigned char*>(arena.allocate(1024 * 1024, 16));
+	ASSERT_NE(big, nullptr);
+	big[1024 * 1024 - 1] = 2;
+	EXPECT_GE(arena.committed_bytes(), 1024u * 1024 + 100);
+	EXPECT_LT(arena.committed_bytes(), 2u * 1024 * 1024);
+}
+
+TEST(VirtualArenaTest, ResetDecommitsAboveWatermark){
+	VirtualArenaDesc desc;
+	desc.reserve_bytes = 16 * 1024 * 1024;
+	desc.decommit_watermark = 128 * 1024;
+	VirtualArena arena(desc);
+
+	ASSERT_NE(arena.allocate(4 * 1024 * 1024, 16), nullptr);
+	EXPECT_GE(arena.committed_bytes(), 4u * 1024 * 1024);
+
+	arena.reset();
+	EXPECT_EQ(arena.in_use(), 0u);
+	EXPECT_LE(arena.committed_bytes(), 128u * 1024 + VirtualMemory::get_page_size());
+
+	// decommitted pages come back on demand
+	auto* p = static_cast<unsigned char*>(arena.allocate(4 * 1024 * 1024, 16));
+	ASSERT_NE(p, nullptr);
+	p[4 * 1024 * 1024 - 1] = 3;
+	EXPECT_EQ(arena.stats().resets, 1u);
+}
+
+TEST(VirtualArenaTest, ReturnsNullPastReservation){
+	VirtualArena arena(1024 * 1024);
+
+	EXPECT_EQ(arena.allocate(2 * 1024 * 1024, 16), nullptr);
+	const auto m = arena.get_marker();
+	ASSERT_NE(arena.allocate(512 * 1024, 16), nullptr);
+	arena.rollback(m);
+	EXPECT_EQ(arena.in_use(), 0u);
+	EXPECT_NE(arena.allocate(arena.capacity(), 1), nullptr);
+}
+
+TEST(ScratchArenaTest, ScopesRollBackAndResetOnExit){
+	VirtualArena& arena = ScratchArenas::local();
+	EXPECT_EQ(&arena, &ScratchArenas::local());
+	{
+		ScratchScope outer;
+		ASSERT_NE(outer.allocate(1000, 16), nullptr);
+		const std::size_t used = arena.in_use();
+		{
+			ScratchScope inner;
+			ASSERT_NE(inner.allocate(4000, 16), nullptr);
+			EXPECT_GT(arena.in_use(), used);
+		}
+		EXPECT_EQ(arena.in_use(), used);
+	}
+	EXPECT_EQ(arena.in_use(), 0u);
+}
+
+TEST(ScratchArenaTest, NestedScopeOnEmptyArenaOnlyRollsBack){
+	VirtualArena& arena = ScratchArenas::local();
+	const std::size_t resets = arena.stats().resets;
+	{
+		ScratchScope outer;
+		{
+			// same marker as the outer scope, which is still live
+			ScratchScope inner;
+			ASSERT_NE(inner.allocate(4000, 16), nullptr);
+		}
+		EXPECT_EQ(arena.stats().resets, resets);
+		ASSERT_NE(outer.allocate(1000, 16), nullptr);
+	}
+	EXPECT_EQ(arena.stats().resets, resets + 1);
+	EXPECT_EQ(arena.in_use(), 0u);
+}
+
+TEST(ScratchArenaTest, ThreadsGetOwnArenasAndReportPeaks){
+	constexpr int kThreads = 4;
+	std::vector<VirtualArena*> arenas(kThreads);
+	std::atomic<int> ready = 0;
+	std::atomic<bool> done = false;
+
+	std::vector<std::thread> threads;
+	for(int t = 0; t < kThreads; ++t){
+		threads.emplace_back([&, t]{
+			{
+				ScratchScope scope;
+				auto* p = static_cast<unsigned char*>(
+					scope.allocate(static_cast<std::size_t>(t + 1) * 64 * 1024, 16));
+				ASSERT_NE(p, nullptr);
+				p[0] = static_cast<unsigned char>(t);
+				arenas[static_cast<std::size_t>(t)] = &scope.arena();
+			}
+			ready.fetch_add(1);
+			while(!done.load()) std::this_thread::yield();
+		});
+	}
+	while(ready.load() < kThreads) std::this_thread::yield();
+
+	const auto stats = ScratchArenas::snapshot();
+	std::size_t seen = 0;
+	for(int t = 0; t < kThreads; ++t){
+		for(const ScratchArenaStats& s : stats){
+			if(s.thread != threads[static_cast<std::size_t>(t)].get_id()) continue;
+			++seen;
+			EXPECT_EQ(s.in_use, 0u);
+			EXPECT_GE(s.peak, static_cast<std::size_t>(t + 1) * 64 * 1024);
+		}
+	}
+	EXPECT_EQ(seen, static_cast<std::size_t>(kThreads));
+	std::sort(arenas.begin(), arenas.end());
+	EXPECT_EQ(std::unique(arenas.begin(), arenas.end()), arenas.end());
+
+	done.store(true);
+	for(auto& th : threads) th.join();
+
+	// exited threads leave the registry
+	for(const ScratchArenaStats& s : ScratchArenas::snapshot()){
+		EXPECT_EQ(s.thread, std::this_thread::get_id());
+	}
+}
+
+TEST(FrameArenaTest, RotatesAndKeepsPreviousFrames){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+	FrameArena frames(backing, 4096, 3);
+
+	int* f0 = static_cast<int*>(frames.allocate(sizeof(int), alignof(int)));
+	ASSERT_NE(f0, nullptr);
+	*f0 = 10;
+
+	frames.begin_frame();
+	int* f1 = static_cast<int*>(frames.allocate(sizeof(int), alignof(int)));
+	ASSERT_NE(f1, nullptr);
+	*f1 = 11;
+
+	frames.begin_frame();
+	EXPECT_EQ(frames.frame_index(), 2u);
+	EXPECT_EQ(frames.in_use(), 0u);
+	EXPECT_EQ(*f0, 10);
+	EXPECT_EQ(*f1, 11);
+	EXPECT_EQ(frames.previous(1).in_use(), sizeof(int));
+
+	// frame 0 retires now, its arena is the only one reset
+	frames.begin_frame();
+	EXPECT_EQ(frames.in_use(), 0u);
+	EXPECT_EQ(*f1, 11);
+	EXPECT_EQ(frames.allocate(sizeof(int), alignof(int)), f0);
+}
+
+TEST(FrameArenaTest, PurgesTailAboveRecentHighWater){
+	PageAllocator backing;
+	backing.init(4 * 1024 * 1024);
+	const std::size_t page = backing.page_size();
+	FrameArena frames(backing, 16 * page, 2, true);
+
+	// one spike frame followed by a long run of small ones
+	auto* spike = static_cast<unsigned char*>(frames.allocate(8 * page, 16));
+	ASSERT_NE(spike, nullptr);
+	std::memset(spike, 0xAB, 8 * page);
+
+	for(int i = 0; i < 40; ++i){
+		frames.begin_frame();
+		ASSERT_NE(frames.allocate(100, 16), nullptr);
+	}
+	EXPECT_GT(frames.purged_bytes(), 0u);
+	EXPECT_LE(frames.purged_bytes(), 8 * page);
+
+	// the purged range is still usable
+	frames.begin_frame();
+	auto* again = static_cast<unsigned char*>(frames.allocate(8 * page, 16));
+	ASSERT_NE(again, nullptr);
+	std::memset(again, 0xCD, 8 * page);
+	EXPECT_EQ(again[8 * page - 1], 0xCD);
+}
+
+TEST(FrameArenaTest, WorksThroughArenaHandle){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+	FrameArena frames(backing, 4096);
+	auto handle = AllocatorHandle::from_arena(frames);
+
+	EXPECT_NE(handle.allocate(64), nullptr);
+	EXPECT_EQ(frames.in_use(), 64u);
+	handle.reset();
+	EXPECT_EQ(frames.in_use(), 0u);
+	EXPECT_EQ(frames.frame_index(), 0u);
+}
+
 TEST(PoolAllocatorTest, ReusesMemory){
 	PageAllocator backing;
 	backing.init(4096);
@@ -198,6 +569,26 @@ TEST(PoolAllocatorTest, ResetRestoresPool){
 	EXPECT_EQ(pool.free_count(), count);
 }
 
+TEST(PoolAllocatorTest, HandsOutUntouchedSlotsInOrder){
+	PageAllocator backing;
+	backing.init(4096);
+
+	PoolAllocator pool(backing, 32, 8, 32);
+	auto* first = static_cast<std::byte*>(pool.allocate(32, 32));
+	auto* second = static_cast<std::byte*>(pool.allocate(32, 32));
+	ASSERT_NE(first, nullptr);
+	EXPECT_EQ(second - first, 32);
+
+	// returned slots win over untouched ones
+	pool.deallocate(first);
+	EXPECT_EQ(pool.allocate(32, 32), first);
+	EXPECT_EQ(static_cast<std::byte*>(pool.allocate(32, 32)) - first, 64);
+
+	pool.reset();
+	EXPECT_EQ(pool.free_count(), 8u);
+	EXPECT_EQ(pool.allocate(32, 32), first);
+}
+
 TEST(PoolAllocatorTest, Stress){
 	PageAllocator backing;
 	backing.init(1000*64);
@@ -265,6 +656,505 @@ TEST(PoolAllocatorTest, CorrectStridingWithAlignment){
 	EXPECT_EQ(distance % 16, 0u);
 }
 
+TEST(PoolAllocatorTest, StatsTrackOccupancy){
+	PageAllocator backing;
+	backing.init(4096);
+
+	PoolAllocator pool(backing, 32, 4);
+	void*a = pool.allocate(32, 8);
+	void*b = pool.allocate(32, 8);
+	void*c = pool.allocate(32, 8);
+	pool.deallocate(b);
+
+	PoolStats s = pool.stats();
+	EXPECT_EQ(s.capacity, 4u);
+	EXPECT_EQ(s.live, 2u);
+	EXPECT_EQ(s.free, 2u);
+	EXPECT_EQ(s.high_water, 3u);
+	EXPECT_EQ(s.failed_allocs, 0u);
+
+	void*d = pool.allocate(32, 8);
+	void*e = pool.allocate(32, 8);
+	EXPECT_EQ(pool.allocate(32, 8), nullptr);
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(c, nullptr);
+	ASSERT_NE(d, nullptr);
+	ASSERT_NE(e, nullptr);
+
+	s = pool.stats();
+	EXPECT_EQ(s.live, 4u);
+	EXPECT_EQ(s.high_water, 4u);
+	EXPECT_EQ(s.failed_allocs, 1u);
+
+	pool.reset();
+	s = pool.stats();
+	EXPECT_EQ(s.live, 0u);
+	EXPECT_EQ(s.free, 4u);
+	EXPECT_EQ(s.high_water, 4u);
+}
+
+TEST(PoolAllocatorTest, StatsSampledFromAnotherThread){
+	PageAllocator backing;
+	backing.init(64 * 1024);
+
+	constexpr std::size_t count = 1000;
+	PoolAllocator pool(backing, 16, count);
+
+	std::atomic<bool> done = false;
+	std::thread sampler([&]{
+		while(!done.load()){
+			PoolStats s = pool.stats();
+			EXPECT_LE(s.live, count);
+		}
+	});
+
+	for(std::size_t i = 0; i < count; ++i){
+		ASSERT_NE(pool.allocate(16, 8), nullptr);
+	}
+	done = true;
+	sampler.join();
+
+	EXPECT_EQ(pool.stats().high_water, count);
+}
+
+TEST(ConcurrentPoolAllocatorTest, StatsTrackOccupancy){
+	PageAllocator backing;
+	backing.init(4096);
+
+	ConcurrentPoolAllocator pool(backing, 32, 2);
+	void*a = pool.allocate(32, 8);
+	void*b = pool.allocate(32, 8);
+	EXPECT_EQ(pool.allocate(32, 8), nullptr);
+	pool.deallocate(a);
+
+	PoolStats s = pool.stats();
+	EXPECT_EQ(s.live, 1u);
+	EXPECT_EQ(s.free, 1u);
+	EXPECT_EQ(s.high_water, 2u);
+	EXPECT_EQ(s.failed_allocs, 1u);
+	pool.deallocate(b);
+}
+
+TEST(GrowingPoolAllocatorTest, GrowsPastOneBlock){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	GrowingPoolAllocator pool(backing, 64, page_size);
+	const std::size_t per_block = pool.slots_per_block();
+	ASSERT_GT(per_block, 0u);
+
+	std::vector<void*> items;
+	for(std::size_t i = 0; i < per_block * 3 + 1; ++i){
+		void*p = pool.allocate(64, 16);
+		ASSERT_NE(p, nullptr);
+		std::memset(p, 0xAB, 64);
+		items.push_back(p);
+	}
+	EXPECT_EQ(pool.block_count(), 4u);
+	EXPECT_EQ(pool.capacity(), per_block * 4);
+	EXPECT_EQ(pool.stats().live, items.size());
+
+	// slots of the first block are still where they were
+	EXPECT_EQ(static_cast<unsigned char*>(items[0])[63], 0xAB);
+
+	for(void*p : items) pool.deallocate(p);
+	EXPECT_EQ(pool.free_count(), pool.capacity());
+	EXPECT_EQ(pool.block_count(), 4u);
+}
+
+TEST(GrowingPoolAllocatorTest, ReusesFreedSlotsBeforeGrowing){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	GrowingPoolAllocator pool(backing, 32, page_size);
+
+	std::vector<void*> items;
+	for(std::size_t i = 0; i < pool.slots_per_block() * 2; ++i){
+		items.push_back(pool.allocate(32, 16));
+	}
+	EXPECT_EQ(pool.block_count(), 2u);
+
+	pool.deallocate(items[3]);
+	EXPECT_EQ(pool.allocate(32, 16), items[3]);
+	EXPECT_EQ(pool.block_count(), 2u);
+}
+
+TEST(GrowingPoolAllocatorTest, ReleasesEmptyBlocks){
+	PageAllocator backing;
+	backing.init(4 * 1024 * 1024);
+
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	GrowingPoolAllocator pool(backing, 64, page_size * 4,
+		alignof(std::max_align_t), true);
+
+	std::vector<void*> items;
+	for(std::size_t i = 0; i < pool.slots_per_block() * 3; ++i){
+		void*p = pool.allocate(64, 16);
+		ASSERT_NE(p, nullptr);
+		items.push_back(p);
+	}
+	EXPECT_EQ(pool.block_count(), 3u);
+	const std::size_t committed = backing.committed_bytes();
+
+	for(void*p : items) pool.deallocate(p);
+	// one empty block stays committed, the backing sees the others go
+	EXPECT_EQ(pool.released_block_count(), 2u);
+	EXPECT_EQ(pool.block_count(), 3u);
+	EXPECT_EQ(backing.committed_bytes(), committed - 2 * page_size * 3);
+
+	// released blocks are recommitted on demand
+	items.clear();
+	for(std::size_t i = 0; i < pool.slots_per_block() * 3; ++i){
+		void*p = pool.allocate(64, 16);
+		ASSERT_NE(p, nullptr);
+		std::memset(p, 1, 64);
+		items.push_back(p);
+	}
+	EXPECT_EQ(pool.released_block_count(), 0u);
+	EXPECT_EQ(pool.block_count(), 3u);
+	EXPECT_EQ(backing.committed_bytes(), committed);
+}
+
+TEST(GrowingPoolAllocatorTest, ReturnsBlocksToBacking){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+	const std::size_t page_size = VirtualMemory::get_page_size();
+
+	{
+		GrowingPoolAllocator pool(backing, 64, page_size,
+			alignof(std::max_align_t), true);
+		std::vector<void*> items;
+		for(std::size_t i = 0; i < pool.slots_per_block() * 2; ++i){
+			items.push_back(pool.allocate(64, 16));
+		}
+		for(void*p : items) pool.deallocate(p);
+	}
+
+	void*p = backing.allocate(page_size, page_size);
+	ASSERT_NE(p, nullptr);
+	std::memset(p, 0, page_size);
+}
+
+TEST(SmallObjectAllocatorTest, SizeClassLookup){
+	using SOA = SmallObjectAllocator;
+	EXPECT_EQ(SOA::class_size(SOA::class_index(1)), 16u);
+	EXPECT_EQ(SOA::class_size(SOA::class_index(16)), 16u);
+	EXPECT_EQ(SOA::class_size(SOA::class_index(17)), 32u);
+	EXPECT_EQ(SOA::class_size(SOA::class_index(129)), 160u);
+	EXPECT_EQ(SOA::class_size(SOA::class_index(1000)), 1024u);
+	EXPECT_EQ(SOA::class_size(SOA::class_index(4096)), 4096u);
+	EXPECT_EQ(SOA::class_index(4097), SOA::kClassCount);
+
+	// 48 B slots are only 16 B aligned, a 64 B alignment moves up a class
+	EXPECT_EQ(SOA::class_size(SOA::class_index(40, 64)), 64u);
+	EXPECT_EQ(SOA::class_size(SOA::class_index(100, 256)), 256u);
+
+	for(std::size_t s = 1; s <= SOA::kMaxSmallSize; ++s){
+		ASSERT_GE(SOA::class_size(SOA::class_index(s)), s);
+	}
+}
+
+TEST(SmallObjectAllocatorTest, AllocatesAlignedBlocksPerClass){
+	PageAllocator backing;
+	backing.init(16 * 1024 * 1024);
+	SmallObjectAllocator soa(backing);
+
+	std::vector<std::pair<void*, std::size_t>> items;
+	for(std::size_t size = 8; size <= 4096; size *= 2){
+		for(std::size_t align : {std::size_t{8}, std::size_t{16}, std::size_t{64}}){
+			void*p = soa.allocate(size, align);
+			ASSERT_NE(p, nullptr);
+			EXPECT_TRUE(backing.owns(p));
+			EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % align, 0u);
+			std::memset(p, 0x5A, size);
+			items.emplace_back(p, size);
+		}
+	}
+
+	for(auto [p, size] : items){
+		EXPECT_EQ(static_cast<unsigned char*>(p)[size - 1], 0x5A);
+		soa.deallocate(p);
+	}
+
+	for(std::size_t c = 0; c < SmallObjectAllocator::kClassCount; ++c){
+		EXPECT_EQ(soa.class_stats(c).live, 0u);
+	}
+}
+
+TEST(SmallObjectAllocatorTest, LargeRequestsFallBackToHeap){
+	PageAllocator backing;
+	backing.init(4 * 1024 * 1024);
+	SmallObjectAllocator soa(backing);
+
+	void*big = soa.allocate(64 * 1024, 16);
+	ASSERT_NE(big, nullptr);
+	EXPECT_FALSE(backing.owns(big));
+	soa.deallocate(big);
+}
+
+TEST(SmallObjectAllocatorTest, WorksThroughHeapHandle){
+	PageAllocator backing;
+	backing.init(4 * 1024 * 1024);
+	SmallObjectAllocator soa(backing);
+	auto handle = AllocatorHandle::from_heap(soa);
+
+	struct Particle{ float pos[3]; float life; };
+	const std::size_t c = SmallObjectAllocator::class_index(sizeof(Particle));
+
+	Particle* p = alloc_new<Particle>(handle, Particle{{1.f, 2.f, 3.f}, 4.f});
+	ASSERT_NE(p, nullptr);
+	EXPECT_FLOAT_EQ(p->life, 4.f);
+	EXPECT_EQ(soa.class_stats(c).live, 1u);
+
+	free_delete(handle, p);
+	EXPECT_EQ(soa.class_stats(c).live, 0u);
+}
+
+TEST(TlsfAllocatorTest, AllocatesAndCoalesces){
+	PageAllocator backing;
+	backing.init(4 * 1024 * 1024);
+	TlsfAllocator tlsf(backing, 1024 * 1024);
+
+	void*a = tlsf.allocate(100);
+	void*b = tlsf.allocate(3000);
+	void*c = tlsf.allocate(70000);
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(b, nullptr);
+	ASSERT_NE(c, nullptr);
+	std::memset(a, 0xAA, 100);
+	std::memset(b, 0xBB, 3000);
+	std::memset(c, 0xCC, 70000);
+	EXPECT_GE(tlsf.in_use(), 100u + 3000u + 70000u);
+
+	// free out of order, neighbours merge back into one block
+	tlsf.deallocate(b);
+	tlsf.deallocate(a);
+	tlsf.deallocate(c);
+	EXPECT_EQ(tlsf.in_use(), 0u);
+
+	void*whole = tlsf.allocate(tlsf.capacity() / 2);
+	EXPECT_NE(whole, nullptr);
+	tlsf.deallocate(whole);
+}
+
+TEST(TlsfAllocatorTest, RespectsAlignment){
+	PageAllocator backing;
+	backing.init(4 * 1024 * 1024);
+	TlsfAllocator tlsf(backing, 1024 * 1024);
+
+	std::vector<void*> ptrs;
+	for(std::size_t al : {16u, 32u, 64u, 256u, 4096u}){
+		void*p = tlsf.allocate(24, al);
+		ASSERT_NE(p, nullptr);
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % al, 0u);
+		ptrs.push_back(p);
+	}
+	for(void*p : ptrs) tlsf.deallocate(p);
+	EXPECT_EQ(tlsf.in_use(), 0u);
+}
+
+TEST(TlsfAllocatorTest, ReturnsNullOnOOM){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+	TlsfAllocator tlsf(backing, 64 * 1024);
+
+	EXPECT_EQ(tlsf.allocate(128 * 1024), nullptr);
+
+	void*p = tlsf.allocate(40 * 1024);
+	ASSERT_NE(p, nullptr);
+	EXPECT_EQ(tlsf.allocate(40 * 1024), nullptr);
+
+	tlsf.reset();
+	EXPECT_EQ(tlsf.in_use(), 0u);
+	EXPECT_NE(tlsf.allocate(40 * 1024), nullptr);
+}
+
+TEST(TlsfAllocatorTest, RandomStressKeepsBlocksIntact){
+	PageAllocator backing;
+	backing.init(16 * 1024 * 1024);
+	TlsfAllocator tlsf(backing, 8 * 1024 * 1024);
+
+	struct Live{ unsigned char* p; std::size_t size; unsigned char tag; };
+	std::vector<Live> live;
+	std::uint32_t rng = 12345;
+	auto next = [&rng]{ rng = rng * 1664525u + 1013904223u; return rng >> 8; };
+
+	for(int i = 0; i < 20000; ++i){
+		if(live.empty() || next() % 3 != 0){
+			const std::size_t size = 1 + next() % 2048;
+			auto*p = static_cast<unsigned char*>(tlsf.allocate(size, 16u << (next() % 3)));
+			if(!p) continue;
+			const auto tag = static_cast<unsigned char>(i);
+			std::memset(p, tag, size);
+			live.push_back({p, size, tag});
+		}
+		else{
+			const std::size_t idx = next() % live.size();
+			const Live l = live[idx];
+			ASSERT_EQ(l.p[0], l.tag);
+			ASSERT_EQ(l.p[l.size - 1], l.tag);
+			tlsf.deallocate(l.p);
+			live[idx] = live.back();
+			live.pop_back();
+		}
+	}
+	for(const Live& l : live) tlsf.deallocate(l.p);
+	EXPECT_EQ(tlsf.in_use(), 0u);
+	EXPECT_NE(tlsf.allocate(tlsf.capacity() / 2), nullptr);
+}
+
+TEST(TlsfAllocatorTest, WorksThroughHeapHandle){
+	PageAllocator backing;
+	backing.init(4 * 1024 * 1024);
+	TlsfAllocator tlsf(backing, 1024 * 1024);
+	auto handle = AllocatorHandle::from_heap(tlsf);
+
+	struct Mesh{ float verts[300]; int count; };
+	Mesh* m = alloc_new<Mesh>(handle, Mesh{{}, 42});
+	ASSERT_NE(m, nullptr);
+	EXPECT_EQ(m->count, 42);
+	EXPECT_GE(tlsf.in_use(), sizeof(Mesh));
+
+	void*raw = handle.allocate(5000, 64);
+	ASSERT_NE(raw, nullptr);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(raw) % 64, 0u);
+
+	free_delete(handle, m);
+	handle.deallocate(raw);
+	EXPECT_EQ(tlsf.in_use(), 0u);
+}
+
+TEST(ConcurrentPoolAllocatorTest, ReusesMemory){
+	PageAllocator backing;
+	backing.init(4096);
+
+	ConcurrentPoolAllocator pool(backing, 32, 2);
+
+	void* p1 = pool.allocate(32, 8);
+	void* p2 = pool.allocate(32, 8);
+	void* p3 = pool.allocate(32, 8);
+
+	ASSERT_NE(p1, nullptr);
+	ASSERT_NE(p2, nullptr);
+	EXPECT_EQ(p3, nullptr);
+	EXPECT_EQ(pool.free_count(), 0u);
+
+	pool.deallocate(p1);
+	EXPECT_EQ(pool.free_count(), 1u);
+	EXPECT_EQ(pool.allocate(32, 8), p1);
+
+	pool.reset();
+	EXPECT_EQ(pool.free_count(), 2u);
+}
+
+TEST(ConcurrentPoolAllocatorTest, WorksThroughHandle){
+	PageAllocator backing;
+	backing.init(4096);
+	ConcurrentPoolAllocator pool(backing, sizeof(int), 4, alignof(int));
+	auto handle = AllocatorHandle::from_pool(pool);
+
+	int* a = alloc_new<int>(handle, 7);
+	ASSERT_NE(a, nullptr);
+	EXPECT_EQ(*a, 7);
+	EXPECT_EQ(pool.free_count(), 3u);
+
+	free_delete(handle, a);
+	EXPECT_EQ(pool.free_count(), 4u);
+}
+
+TEST(ConcurrentPoolAllocatorTest, CrossThreadFree){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+
+	constexpr std::size_t count = 4096;
+	ConcurrentPoolAllocator pool(backing, 64, count);
+
+	std::vector<void*> items;
+	std::thread producer([&]{
+		for(std::size_t i = 0; i < count; ++i){
+			items.push_back(pool.allocate(64, 8));
+		}
+	});
+	producer.join();
+	EXPECT_EQ(pool.free_count(), 0u);
+
+	std::thread consumer([&]{
+		for(void* p : items) pool.deallocate(p);
+	});
+	consumer.join();
+	EXPECT_EQ(pool.free_count(), count);
+}
+
+TEST(ConcurrentPoolAllocatorTest, FreeCountStaysInRangeUnderContention){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+
+	// a tiny pool runs empty all the time, so the counter keeps racing
+	//	past zero and capacity
+	constexpr std::size_t count = 2;
+	ConcurrentPoolAllocator pool(backing, 64, count);
+
+	std::atomic<bool> stop = false;
+	std::vector<std::thread> workers;
+	for(int t = 0; t < 4; ++t){
+		workers.emplace_back([&]{
+			while(!stop.load()){
+				if(void* p = pool.allocate(64, 8)) pool.deallocate(p);
+			}
+		});
+	}
+
+	std::size_t out_of_range = 0;
+	for(int i = 0; i < 200000; ++i){
+		const PoolStats s = pool.stats();
+		if(pool.free_count() > count || s.free > count || s.live > count){
+			++out_of_range;
+		}
+	}
+	stop = true;
+	for(auto& w : workers) w.join();
+
+	EXPECT_EQ(out_of_range, 0u);
+	EXPECT_EQ(pool.free_count(), count);
+}
+
+TEST(ConcurrentPoolAllocatorTest, NoSlotHandedOutTwice){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+
+	constexpr std::size_t threads = 4;
+	constexpr std::size_t count = 256;
+	constexpr int rounds = 2000;
+	ConcurrentPoolAllocator pool(backing, sizeof(std::size_t), count);
+
+	std::atomic<int> corrupted = 0;
+	std::vector<std::thread> workers;
+	for(std::size_t t = 0; t < threads; ++t){
+		workers.emplace_back([&, t]{
+			void* held[16];
+			for(int r = 0; r < rounds; ++r){
+				std::size_t n = 0;
+				for(; n < 16; ++n){
+					held[n] = pool.allocate(sizeof(std::size_t), 8);
+					if(!held[n]) break;
+					*static_cast<std::size_t*>(held[n]) = t;
+				}
+				std::this_thread::yield();
+				for(std::size_t i = 0; i < n; ++i){
+					if(*static_cast<std::size_t*>(held[i]) != t) ++corrupted;
+					pool.deallocate(held[i]);
+				}
+			}
+		});
+	}
+	for(auto& w : workers) w.join();
+
+	EXPECT_EQ(corrupted.load(), 0);
+	EXPECT_EQ(pool.free_count(), count);
+}
+
 struct SpyObject{
 	static int constructions;
 	static int destructions;
@@ -279,6 +1169,281 @@ struct SpyObject{
 int SpyObject::constructions = 0;
 int SpyObject::destructions = 0;
 
+namespace{
+
+int g_corruptions_seen = 0;
+const char* g_last_corruption = nullptr;
+
+void count_corruption(const AllocationRecord&, const char* what){
+	++g_corruptions_seen;
+	g_last_corruption = what;
+}
+
+} // namespace
+
+TEST(TrackingAllocatorTest, DisabledIsAPassthrough){
+	static_assert(sizeof(TrackingAllocator<DefaultHeap, false>) == sizeof(DefaultHeap*));
+
+	DefaultHeap heap;
+	TrackingAllocator<DefaultHeap, false> tracked(heap, "render");
+	void*p = tracked.allocate(64, 16);
+	ASSERT_NE(p, nullptr);
+	EXPECT_EQ(heap.allocs_, 1u);
+	EXPECT_EQ(tracked.live_count(), 0u);
+	tracked.deallocate(p);
+	EXPECT_EQ(heap.allocs_, 0u);
+}
+
+TEST(TrackingAllocatorTest, RecordsLiveBlocks){
+	DefaultHeap heap;
+	TrackingAllocator<DefaultHeap, true> tracked(heap, "physics");
+
+	void*a = tracked.allocate(100, 64);
+	void*b = tracked.allocate(20, 16, "broadphase");
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(b, nullptr);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a) % 64, 0u);
+	EXPECT_EQ(tracked.live_count(), 2u);
+	EXPECT_EQ(tracked.live_bytes(), 120u);
+
+	std::FILE* out = std::tmpfile();
+	ASSERT_NE(out, nullptr);
+	tracked.dump_live(out);
+	std::rewind(out);
+	char buf[4096] = {};
+	const std::size_t n = std::fread(buf, 1, sizeof(buf) - 1, out);
+	std::fclose(out);
+	const std::string dump(buf, n);
+	EXPECT_NE(dump.find("2 live allocations, 120 bytes"), std::string::npos);
+	EXPECT_NE(dump.find("broadphase: 1 allocations, 20 bytes"), std::string::npos);
+	EXPECT_NE(dump.find("memory_test.cpp"), std::string::npos);
+
+	tracked.deallocate(a);
+	tracked.deallocate(b);
+	EXPECT_EQ(tracked.live_count(), 0u);
+	EXPECT_EQ(heap.allocs_, 0u);
+	EXPECT_EQ(tracked.corruption_count(), 0u);
+}
+
+TEST(TrackingAllocatorTest, CallSiteNamesHandleAllocations){
+	DefaultHeap heap;
+	TrackingAllocator<DefaultHeap, true> tracked(heap);
+	AllocatorHandle handle = AllocatorHandle::from_heap(tracked);
+
+	auto dump = [&]{
+		std::FILE* out = std::tmpfile();
+		tracked.dump_live(out);
+		std::rewind(out);
+		char buf[4096] = {};
+		const std::size_t n = std::fread(buf, 1, sizeof(buf) - 1, out);
+		std::fclose(out);
+		return std::string(buf, n);
+	};
+
+	// without a CallSite the handle's own lambda is recorded
+	void* a = handle.allocate(16);
+	EXPECT_NE(dump().find("allocator_handle.hpp"), std::string::npos);
+	handle.deallocate(a);
+
+	unsigned line = 0;
+	{
+		line = std::source_location::current().line() + 1;
+		tracking::CallSite site;
+		a = handle.allocate(16);
+	}
+	const std::string with_site = dump();
+	EXPECT_EQ(with_site.find("allocator_handle.hpp"), std::string::npos);
+	EXPECT_NE(with_site.find("memory_test.cpp:" + std::to_string(line)), std::string::npos);
+	EXPECT_EQ(tracking::current_call_site(), nullptr);
+	handle.deallocate(a);
+}
+
+TEST(TrackingAllocatorTest, WrapsFixedSlotPools){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+
+	// the slot has no room for guards, blocks are recorded out of band
+	PoolAllocator pool(backing, 32, 4);
+	TrackingAllocator<PoolAllocator, true> tracked(pool, "pool");
+	auto* a = static_cast<unsigned char*>(tracked.allocate(32, 16, "bullets"));
+	auto* b = static_cast<unsigned char*>(tracked.allocate(32, 16));
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(b, nullptr);
+	std::memset(a, 1, 32);
+	std::memset(b, 2, 32);
+	EXPECT_EQ(pool.free_count(), 2u);
+	EXPECT_EQ(tracked.live_count(), 2u);
+	EXPECT_EQ(tracked.live_bytes(), 64u);
+	EXPECT_TRUE(tracked.check());
+	EXPECT_EQ(b[0], 2);
+
+	tracked.deallocate(a);
+	EXPECT_EQ(a[31], 0xDD);
+	EXPECT_EQ(pool.free_count(), 3u);
+	tracked.deallocate(b);
+	EXPECT_EQ(tracked.live_count(), 0u);
+
+	ConcurrentPoolAllocator shared(backing, 64, 4);
+	TrackingAllocator<ConcurrentPoolAllocator, true> tracked_shared(shared);
+	void* c = tracked_shared.allocate(64, 16);
+	ASSERT_NE(c, nullptr);
+	EXPECT_EQ(shared.free_count(), 3u);
+	tracked_shared.deallocate(c);
+	EXPECT_EQ(shared.free_count(), 4u);
+}
+
+TEST(TrackingAllocatorTest, DetectsOverrunAndUnderrun){
+	DefaultHeap heap;
+	TrackingAllocator<DefaultHeap, true> tracked(heap);
+	tracked.set_corruption_handler(&count_corruption);
+	g_corruptions_seen = 0;
+
+	auto* p = static_cast<unsigned char*>(tracked.allocate(32));
+	ASSERT_NE(p, nullptr);
+	p[32] = 0;
+	EXPECT_FALSE(tracked.check());
+	EXPECT_EQ(g_corruptions_seen, 1);
+	EXPECT_STREQ(g_last_corruption, "overrun");
+
+	auto* q = static_cast<unsigned char*>(tracked.allocate(32));
+	ASSERT_NE(q, nullptr);
+	q[-1] = 0;
+	tracked.deallocate(q);
+	EXPECT_STREQ(g_last_corruption, "underrun");
+
+	tracked.deallocate(p);
+	EXPECT_EQ(tracked.corruption_count(), 3u);
+}
+
+TEST(TrackingAllocatorTest, WrapsArenasAndPageAllocator){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+	TrackingAllocator<PageAllocator, true> pages(backing, "pages");
+	void*block = pages.allocate(4096, 64);
+	ASSERT_NE(block, nullptr);
+	pages.deallocate(block, 4096);
+	EXPECT_EQ(pages.live_count(), 0u);
+
+	LinearArena arena(backing, 4096);
+	TrackingAllocator<LinearArena, true> tracked(arena, "frame");
+	auto handle = AllocatorHandle::from_arena(tracked);
+	ASSERT_NE(handle.allocate(100), nullptr);
+	EXPECT_EQ(tracked.live_count(), 1u);
+	handle.reset();
+	EXPECT_EQ(tracked.live_count(), 0u);
+	EXPECT_EQ(arena.in_use(), 0u);
+}
+
+namespace{
+
+std::string g_over_budget_node;
+std::size_t g_over_budget_used = 0;
+
+void record_over_budget(const MemoryBudget& node, std::size_t used){
+	g_over_budget_node = node.name();
+	g_over_budget_used = used;
+}
+
+} // namespace
+
+TEST(MemoryBudgetTest, UsageRollsUpAndCallsBackOnce){
+	MemoryBudget root("engine");
+	MemoryBudget physics("physics", &root, 1000);
+	MemoryBudget broadphase("broadphase", &physics);
+	physics.set_callback(&record_over_budget);
+	g_over_budget_node.clear();
+
+	broadphase.charge(600);
+	physics.charge(300);
+	EXPECT_EQ(broadphase.used(), 600u);
+	EXPECT_EQ(physics.used(), 900u);
+	EXPECT_EQ(physics.self_used(), 300u);
+	EXPECT_EQ(root.used(), 900u);
+	EXPECT_TRUE(g_over_budget_node.empty());
+
+	broadphase.charge(200);
+	EXPECT_EQ(g_over_budget_node, "physics");
+	EXPECT_EQ(g_over_budget_used, 1100u);
+	broadphase.charge(50);
+	EXPECT_EQ(physics.overruns(), 1u);
+
+	broadphase.release(850);
+	EXPECT_EQ(root.used(), 300u);
+	EXPECT_EQ(physics.peak(), 1150u);
+}
+
+TEST(MemoryBudgetTest, SnapshotWalksWholeTree){
+	MemoryBudget root("engine");
+	MemoryBudget render("render", &root, 200);
+	MemoryBudget physics("physics", &root, 50);
+	MemoryBudget pools("pools", &physics);
+	pools.charge(10);
+	render.charge(20);
+
+	const auto snap = root.snapshot();
+	ASSERT_EQ(snap.size(), 4u);
+	EXPECT_EQ(snap[0].name, "engine");
+	EXPECT_EQ(snap[0].used, 30u);
+	EXPECT_EQ(snap[0].depth, 0u);
+
+	const auto it = std::find_if(snap.begin(), snap.end(),
+		[](const BudgetNodeStats& s){return s.name == "pools";});
+	ASSERT_NE(it, snap.end());
+	EXPECT_EQ(it->depth, 2u);
+	EXPECT_EQ(it->used, 10u);
+	EXPECT_EQ((it - 1)->name, "physics");
+}
+
+TEST(MemoryBudgetTest, DestroyedNodeLeavesTree){
+	MemoryBudget root("engine");
+	{
+		MemoryBudget scratch("scratch", &root);
+		scratch.charge(64);
+		EXPECT_EQ(root.used(), 64u);
+		EXPECT_EQ(root.snapshot().size(), 2u);
+	}
+	EXPECT_EQ(root.used(), 0u);
+	EXPECT_EQ(root.snapshot().size(), 1u);
+}
+
+TEST(MemoryBudgetTest, AllocatorsChargeTheirNodes){
+	MemoryBudget root("engine");
+	MemoryBudget os("os", &root);
+	MemoryBudget physics("physics", &root);
+	MemoryBudget particles("particles", &physics);
+
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+	backing.set_budget(&os);
+
+	{
+		LinearArena arena(backing, 4096);
+		EXPECT_EQ(os.used(), backing.committed_bytes());
+		arena.set_budget(&physics);
+		ASSERT_NE(arena.allocate(100, 1), nullptr);
+		const auto m = arena.get_marker();
+		ASSERT_NE(arena.allocate(50, 1), nullptr);
+		EXPECT_EQ(physics.used(), 150u);
+		arena.rollback(m);
+		EXPECT_EQ(physics.used(), 100u);
+
+		PoolAllocator pool(backing, 32, 16, 16);
+		pool.set_budget(&particles);
+		void*a = pool.allocate(32, 16);
+		void*b = pool.allocate(32, 16);
+		EXPECT_EQ(particles.used(), 64u);
+		EXPECT_EQ(physics.used(), 164u);
+		pool.deallocate(a);
+		EXPECT_EQ(particles.used(), 32u);
+		(void)b;
+	}
+	EXPECT_EQ(physics.used(), 0u);
+
+	backing.reset(true);
+	EXPECT_EQ(os.used(), 0u);
+	EXPECT_GT(os.peak(), 0u);
+}
+
 TEST(AllocatorHandleTest, CallsConstructorAndDestructors){
 	SpyObject::constructions = 0;
 	SpyObject::destructions = 0;
@@ -319,6 +1484,57 @@ TEST(AllocatorHandleTest, ForwardsArguments){
 	free_delete(handle,e);
 }
 
+TEST(StaticAllocatorRefTest, ForwardsToPoolAndArena){
+	PageAllocator backing;
+	backing.init(64 * 1024);
+	PoolAllocator pool(backing, sizeof(Entity), 4, alignof(std::max_align_t));
+	StaticAllocatorRef pool_ref(pool);
+	static_assert(decltype(pool_ref)::can_free && decltype(pool_ref)::can_reset);
+
+	Entity* e = alloc_new<Entity>(pool_ref, 1, 2);
+	ASSERT_NE(e, nullptr);
+	EXPECT_EQ(e->y, 2);
+	EXPECT_EQ(pool.stats().live, 1u);
+	free_delete(pool_ref, e);
+	EXPECT_EQ(pool.stats().live, 0u);
+
+	LinearArena arena(backing, 1024);
+	StaticAllocatorRef arena_ref(arena);
+	static_assert(!decltype(arena_ref)::can_free);
+	ASSERT_NE(arena_ref.allocate(64), nullptr);
+	arena_ref.deallocate(nullptr);
+	arena_ref.reset();
+	EXPECT_EQ(arena.in_use(), 0u);
+
+	// type erased view behaves the same
+	auto handle = pool_ref.handle();
+	EXPECT_TRUE(handle.can_free);
+	free_delete(handle, alloc_new<Entity>(handle, 3, 4));
+	EXPECT_EQ(pool.stats().live, 0u);
+}
+
+TEST(StaticAllocatorRefTest, PmrContainersDrawFromEngineAllocators){
+	PageAllocator backing;
+	backing.init(1024 * 1024);
+	TlsfAllocator tlsf(backing, 512 * 1024);
+	HandleMemoryResource resource(StaticAllocatorRef{tlsf});
+
+	{
+		std::pmr::vector<int> v(&resource);
+		for(int i = 0; i < 1000; ++i) v.push_back(i);
+		EXPECT_EQ(v[999], 999);
+		EXPECT_GE(tlsf.in_use(), 1000 * sizeof(int));
+	}
+	EXPECT_EQ(tlsf.in_use(), 0u);
+
+	LinearArena arena(backing, 4096);
+	HandleMemoryResource arena_resource(AllocatorHandle::from_arena(arena));
+	std::pmr::vector<char> small(&arena_resource);
+	small.reserve(100);
+	EXPECT_GE(arena.in_use(), 100u);
+	EXPECT_THROW(small.reserve(8192), std::bad_alloc);
+}
+
 TEST(PageAllocatorTest, ReturnsPageAlignedAddress){
 	PageAllocator pa;
 	std::size_t page_size = VirtualMemory::get_page_size();
@@ -363,6 +1579,296 @@ TEST(PageAllocatorTest, ReusesFreedPages){
 	ASSERT_NE(p3, nullptr);
 }
 
+TEST(PageAllocatorTest, ReusesOutOfOrderFrees){
+	PageAllocator pa;
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	pa.init(page_size * 8);
+
+	auto* a = static_cast<std::byte*>(pa.allocate(page_size * 2, 1));
+	auto* b = static_cast<std::byte*>(pa.allocate(page_size * 2, 1));
+	auto* c = static_cast<std::byte*>(pa.allocate(page_size * 2, 1));
+	auto* d = static_cast<std::byte*>(pa.allocate(page_size * 2, 1));
+	ASSERT_NE(d, nullptr);
+	ASSERT_EQ(pa.allocate(page_size, 1), nullptr);
+
+	// neighbours coalesce into one run
+	pa.deallocate(b, page_size * 2);
+	pa.deallocate(a, page_size * 2);
+	EXPECT_EQ(pa.stats().free_ranges, 1u);
+	EXPECT_EQ(pa.stats().free_bytes, page_size * 4);
+
+	EXPECT_EQ(pa.allocate(page_size * 4, 1), a);
+	EXPECT_EQ(pa.stats().free_ranges, 0u);
+
+	// sub page requests still take a whole page each
+	pa.deallocate(a, page_size * 4);
+	auto* small1 = static_cast<std::byte*>(pa.allocate(100, 16));
+	auto* small2 = static_cast<std::byte*>(pa.allocate(100, 16));
+	EXPECT_EQ(small1, a);
+	EXPECT_EQ(small2, a + page_size);
+	(void)c;
+}
+
+TEST(PageAllocatorTest, PicksBestFittingFreeRun){
+	PageAllocator pa;
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	pa.init(page_size * 16);
+
+	auto* big = static_cast<std::byte*>(pa.allocate(page_size * 3, 1));
+	ASSERT_NE(pa.allocate(page_size, 1), nullptr);
+	auto* small = static_cast<std::byte*>(pa.allocate(page_size, 1));
+	ASSERT_NE(pa.allocate(page_size, 1), nullptr);
+
+	pa.deallocate(big, page_size * 3);
+	pa.deallocate(small, page_size);
+	EXPECT_EQ(pa.allocate(page_size, 1), small);
+	// the remainder of a split run stays free
+	EXPECT_EQ(pa.allocate(page_size, 1), big);
+	EXPECT_EQ(pa.stats().free_bytes, page_size * 2);
+}
+
+TEST(PageAllocatorTest, DecommitsFreedRunsAndRecommitsOnReuse){
+	PageAllocatorDesc desc;
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	desc.max_size_bytes = page_size * 8;
+	desc.decommit_freed = true;
+
+	PageAllocator pa;
+	pa.init(desc);
+	auto* a = static_cast<std::byte*>(pa.allocate(page_size * 2, 1));
+	auto* b = static_cast<std::byte*>(pa.allocate(page_size * 2, 1));
+	auto* c = static_cast<std::byte*>(pa.allocate(page_size * 2, 1));
+	std::memset(a, 1, page_size * 6);
+	EXPECT_EQ(pa.committed_bytes(), page_size * 6);
+
+	pa.deallocate(b, page_size * 2);
+	EXPECT_EQ(pa.committed_bytes(), page_size * 4);
+	EXPECT_EQ(pa.stats().decommit_calls, 1u);
+
+	auto* b2 = static_cast<std::byte*>(pa.allocate(page_size, 1));
+	ASSERT_EQ(b2, b);
+	std::memset(b2, 2, page_size);
+	EXPECT_EQ(pa.committed_bytes(), page_size * 5);
+
+	// freeing the top chunk pulls the decommitted run below it back
+	//	under the bump pointer, recommitted
+	pa.deallocate(c, page_size * 2);
+	EXPECT_EQ(pa.stats().free_ranges, 0u);
+	auto* tail = static_cast<std::byte*>(pa.allocate(page_size * 3, 1));
+	ASSERT_EQ(tail, b + page_size);
+	std::memset(tail, 3, page_size * 3);
+
+	// holes left at reset are recommitted for the bump path
+	pa.deallocate(a, page_size * 2);
+	pa.reset();
+	auto* all = static_cast<std::byte*>(pa.allocate(page_size * 6, 1));
+	ASSERT_EQ(all, a);
+	std::memset(all, 4, page_size * 6);
+	EXPECT_EQ(pa.committed_bytes(), page_size * 6);
+}
+
+TEST(PageAllocatorTest, ReclaimsOnWorkerAndWaitsBeforeReuse){
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	PageWorker worker;
+
+	for(auto mode : {ReclaimMode::Decommit, ReclaimMode::LazyFree}){
+		PageAllocatorDesc desc;
+		desc.max_size_bytes = page_size * 64;
+		desc.decommit_freed = true;
+		desc.worker = &worker;
+		desc.reclaim_mode = mode;
+
+		PageAllocator pa;
+		pa.init(desc);
+		auto* a = static_cast<std::byte*>(pa.allocate(page_size * 32, 1));
+		auto* b = static_cast<std::byte*>(pa.allocate(page_size * 32, 1));
+		ASSERT_NE(b, nullptr);
+		std::memset(a, 1, page_size * 64);
+
+		// accounting is immediate, the syscalls happen on the worker
+		pa.reset(true);
+		EXPECT_EQ(pa.committed_bytes(), 0u);
+
+		// reusing the range waits for the worker, then commits again
+		a = static_cast<std::byte*>(pa.allocate(page_size * 32, 1));
+		ASSERT_NE(a, nullptr);
+		std::memset(a, 2, page_size * 32);
+		EXPECT_EQ(pa.committed_bytes(), page_size * 32);
+
+		b = static_cast<std::byte*>(pa.allocate(page_size * 16, 1));
+		ASSERT_NE(pa.allocate(page_size * 16, 1), nullptr);
+		pa.deallocate(b, page_size * 16);
+		auto* again = static_cast<std::byte*>(pa.allocate(page_size * 8, 1));
+		ASSERT_EQ(again, b);
+		std::memset(again, 3, page_size * 8);
+		EXPECT_EQ(a[0], std::byte{2});
+	}
+
+	worker.flush();
+	EXPECT_EQ(worker.pending(), 0u);
+	EXPECT_EQ(worker.jobs_done(), 4u);
+	EXPECT_EQ(worker.bytes_reclaimed(), 2 * page_size * (64 + 16));
+}
+
+TEST(PageAllocatorTest, ResetRecommitsHolesBeforeReopeningTheRange){
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	PageWorker worker;
+
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = 64 * 1024 * 1024;
+	desc.decommit_freed = true;
+	desc.worker = &worker;
+	desc.thread_chunk_bytes = page_size * 16;
+
+	PageAllocator pa;
+	pa.init(desc);
+
+	// chunks carved after a reset must never land on a hole the worker
+	//	is still decommitting, touching one would fault
+	std::atomic<bool> stop = false;
+	std::thread writer([&]{
+		while(!stop.load()){
+			auto* p = static_cast<std::byte*>(pa.allocate(64, 16));
+			if(p) std::memset(p, 1, 64);
+		}
+	});
+
+	for(int i = 0; i < 200; ++i){
+		void* blocks[4];
+		for(auto& b : blocks){
+			b = pa.allocate(page_size * 8, page_size);
+			ASSERT_NE(b, nullptr);
+		}
+		pa.deallocate(blocks[1], page_size * 8);
+		pa.deallocate(blocks[2], page_size * 8);
+		pa.reset();
+	}
+
+	stop = true;
+	writer.join();
+	worker.flush();
+}
+
+TEST(PageAllocatorTest, ResetRecommitsLentPages){
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	PageAllocator pa;
+	pa.init(page_size * 16);
+
+	auto* block = static_cast<std::byte*>(pa.allocate(page_size * 8, 1));
+	ASSERT_NE(block, nullptr);
+	pa.decommit_pages(block + page_size, page_size * 6);
+	EXPECT_EQ(pa.committed_bytes(), page_size * 2);
+
+	// the block dies with the reset, the bump path needs its pages back
+	pa.reset();
+	EXPECT_EQ(pa.committed_bytes(), page_size * 8);
+	auto* again = static_cast<std::byte*>(pa.allocate(page_size * 8, 1));
+	ASSERT_EQ(again, block);
+	std::memset(again, 1, page_size * 8);
+
+	pa.decommit_pages(again, page_size * 4);
+	ASSERT_TRUE(pa.recommit_pages(again, page_size * 4));
+	std::memset(again, 2, page_size * 8);
+	EXPECT_EQ(pa.committed_bytes(), page_size * 8);
+}
+
+TEST(PageAllocatorTest, ResetOnlyRecommitsDecommittedRuns){
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	MemoryBudget budget("pages");
+	PageAllocator pa;
+	pa.init(page_size * 16);
+	pa.set_budget(&budget);
+
+	// the free run stays committed, only the lent hole is a real hole
+	auto* a = static_cast<std::byte*>(pa.allocate(page_size * 4, 1));
+	ASSERT_NE(pa.allocate(page_size * 4, 1), nullptr);
+	auto* c = static_cast<std::byte*>(pa.allocate(page_size * 4, 1));
+	ASSERT_NE(c, nullptr);
+	pa.deallocate(a, page_size * 4);
+	pa.decommit_pages(c + page_size, page_size * 2);
+	EXPECT_EQ(pa.committed_bytes(), page_size * 10);
+
+	pa.reset();
+	EXPECT_EQ(pa.committed_bytes(), page_size * 12);
+	EXPECT_EQ(budget.used(), page_size * 12);
+	auto* all = static_cast<std::byte*>(pa.allocate(page_size * 12, 1));
+	ASSERT_EQ(all, a);
+	std::memset(all, 1, page_size * 12);
+	pa.set_budget(nullptr);
+}
+
+TEST(PageAllocatorTest, CommitsAheadAndPrefaults){
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	PageWorker worker;
+
+	for(auto* w : {static_cast<PageWorker*>(nullptr), &worker}){
+		PageAllocatorDesc desc;
+		desc.max_size_bytes = page_size * 32;
+		desc.commit_ahead_bytes = page_size * 8;
+		desc.prefault = w ? PrefaultMode::Populate : PrefaultMode::Touch;
+		desc.worker = w;
+
+		PageAllocator pa;
+		pa.init(desc);
+
+		ASSERT_NE(pa.allocate(page_size, 1), nullptr);
+		EXPECT_EQ(pa.committed_bytes(), page_size * 9);
+		EXPECT_EQ(pa.stats().prefaulted, page_size * 9);
+
+		// served from the window without another commit
+		auto* p = static_cast<std::byte*>(pa.allocate(page_size * 8, 1));
+		ASSERT_NE(p, nullptr);
+		std::memset(p, 1, page_size * 8);
+		EXPECT_EQ(pa.stats().commit_calls, 1u);
+
+		// the window is clamped to the reservation
+		ASSERT_NE(pa.allocate(page_size * 23, 1), nullptr);
+		EXPECT_EQ(pa.committed_bytes(), page_size * 32);
+		EXPECT_EQ(pa.allocate(page_size, 1), nullptr);
+	}
+
+	worker.flush();
+	EXPECT_EQ(worker.bytes_prefaulted(), page_size * 32);
+}
+
+TEST(PageAllocatorTest, GuardPagesSeparateBlocks){
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = page_size * 16;
+	desc.guard_pages = true;
+
+	PageAllocator pa;
+	pa.init(desc);
+
+	auto* a = static_cast<std::byte*>(pa.allocate(page_size * 2, 1));
+	auto* b = static_cast<std::byte*>(pa.allocate(100, 16));
+	ASSERT_NE(b, nullptr);
+	// every block is followed by a guard
+	EXPECT_EQ(b - a, static_cast<std::ptrdiff_t>(page_size * 3));
+	std::memset(a, 1, page_size * 2);
+	std::memset(b, 1, page_size);
+
+	// guard pages hold no memory
+	EXPECT_EQ(pa.committed_bytes(), page_size * 3);
+
+	EXPECT_DEATH({ a[page_size * 2] = std::byte{1}; }, "");
+	EXPECT_DEATH({ a[-1] = std::byte{1}; }, "");
+
+	// a freed block takes its guard along, reuse puts a new one in place
+	pa.deallocate(a, page_size * 2);
+	auto* c = static_cast<std::byte*>(pa.allocate(page_size, 1));
+	ASSERT_EQ(c, a);
+	std::memset(c, 2, page_size);
+	EXPECT_DEATH({ c[page_size] = std::byte{1}; }, "");
+
+	// after reset the whole range is plain memory again
+	pa.reset();
+	auto* all = static_cast<std::byte*>(pa.allocate(page_size * 14, 1));
+	ASSERT_EQ(all, a);
+	std::memset(all, 3, page_size * 14);
+	EXPECT_EQ(pa.allocate(page_size, 1), nullptr);
+}
+
 TEST(PageAllocatorTest, HugeAllocation){
 	PageAllocator pa;
 	std::size_t page_size = VirtualMemory::get_page_size();
@@ -388,6 +1894,193 @@ TEST(PageAllocatorTest, HugeAllocation2){
 	ASSERT_NE(p, nullptr);
 }
 
+TEST(PageAllocatorTest, StatsTrackCommits){
+	PageAllocator pa;
+	std::size_t page_size = VirtualMemory::get_page_size();
+	pa.init(page_size * 8);
+
+	ASSERT_NE(pa.allocate(page_size, 1), nullptr);
+	ASSERT_NE(pa.allocate(page_size * 2, 1), nullptr);
+	pa.reset(true);
+
+	PageAllocatorStats s = pa.stats();
+	EXPECT_EQ(s.reserved, page_size * 8);
+	EXPECT_EQ(s.committed, 0u);
+	EXPECT_EQ(s.peak_committed, page_size * 3);
+	EXPECT_EQ(s.commit_calls, 2u);
+	EXPECT_EQ(s.decommit_calls, 1u);
+}
+
+TEST(PageAllocatorTest, HugePagesReportBackingAndGranularity){
+	const std::size_t huge = VirtualMemory::get_huge_page_size();
+	if(huge == 0) GTEST_SKIP() << "no huge page support";
+
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = huge * 4;
+	desc.huge_pages = true;
+
+	PageAllocator pa;
+	pa.init(desc);
+	EXPECT_EQ(pa.reserved_bytes() % huge, 0u);
+
+	void*p = pa.allocate(100, 16);
+	ASSERT_NE(p, nullptr);
+	static_cast<char*>(p)[99] = 1;
+
+	if(pa.page_backing() == PageBacking::Regular){
+		EXPECT_EQ(pa.page_size(), VirtualMemory::get_page_size());
+	}
+	else{
+		EXPECT_EQ(pa.page_size(), huge);
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % huge, 0u);
+		EXPECT_EQ(pa.committed_bytes(), huge);
+	}
+}
+
+TEST(PageAllocatorTest, NumaPolicyCommitsUsableMemory){
+	const int nodes = VirtualMemory::numa_node_count();
+	ASSERT_GE(nodes, 1);
+	const int here = VirtualMemory::current_numa_node();
+	EXPECT_GE(here, 0);
+	EXPECT_LT(here, nodes);
+
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	for(auto policy : {NumaPolicy::Local, NumaPolicy::Node}){
+		PageAllocatorDesc desc;
+		desc.max_size_bytes = page_size * 16;
+		desc.numa_policy = policy;
+		desc.numa_node = nodes - 1;
+
+		PageAllocator pa;
+		pa.init(desc);
+		// single node machines fall back to first touch
+		EXPECT_EQ(pa.numa_policy(), nodes > 1 ? policy : NumaPolicy::FirstTouch);
+
+		auto* p = static_cast<unsigned char*>(pa.allocate(page_size * 8, 64));
+		ASSERT_NE(p, nullptr);
+		std::memset(p, 0xAB, page_size * 8);
+		EXPECT_EQ(p[page_size * 8 - 1], 0xAB);
+	}
+
+	// an out of range node degrades to a plain commit
+	VirtualArenaDesc vdesc;
+	vdesc.reserve_bytes = page_size * 4;
+	vdesc.numa_policy = NumaPolicy::Node;
+	vdesc.numa_node = nodes + 7;
+	VirtualArena arena(vdesc);
+	auto* q = static_cast<char*>(arena.allocate(page_size));
+	ASSERT_NE(q, nullptr);
+	q[page_size - 1] = 1;
+}
+
+TEST(PageAllocatorTest, ThreadChunkServesSmallRequests){
+	std::size_t page_size = VirtualMemory::get_page_size();
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = page_size * 64;
+	desc.thread_chunk_bytes = page_size * 4;
+
+	PageAllocator pa;
+	pa.init(desc);
+
+	void*p1 = pa.allocate(64, 16);
+	void*p2 = pa.allocate(64, 16);
+	ASSERT_NE(p1, nullptr);
+	ASSERT_NE(p2, nullptr);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p1) % page_size, 0u);
+	EXPECT_EQ(static_cast<std::byte*>(p2) - static_cast<std::byte*>(p1), 64);
+	EXPECT_EQ(pa.committed_bytes(), page_size * 4);
+
+	// small frees are ignored, the chunk keeps bumping
+	pa.deallocate(p2, 64);
+	void*p3 = pa.allocate(64, 16);
+	EXPECT_EQ(static_cast<std::byte*>(p3) - static_cast<std::byte*>(p2), 64);
+
+	// large requests bypass the chunk
+	void*big = pa.allocate(page_size * 2, page_size);
+	ASSERT_NE(big, nullptr);
+	EXPECT_GE(static_cast<std::byte*>(big) - static_cast<std::byte*>(p1),
+			static_cast<std::ptrdiff_t>(page_size * 4));
+}
+
+TEST(PageAllocatorTest, OverAlignedSmallBlockIsFreedWithThreadChunks){
+	std::size_t page_size = VirtualMemory::get_page_size();
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = 16 * 1024 * 1024;
+	desc.thread_chunk_bytes = 1024 * 1024;
+
+	PageAllocator pa;
+	pa.init(desc);
+
+	// small but over-aligned, so it takes the locked path and must be
+	//	recycled even though its size fits a thread chunk
+	for(int i = 0; i < 1000; ++i){
+		void*p = pa.allocate(64, page_size * 2);
+		ASSERT_NE(p, nullptr) << "iteration " << i;
+		pa.deallocate(p, 64);
+	}
+}
+
+TEST(PageAllocatorTest, ResetInvalidatesThreadChunks){
+	std::size_t page_size = VirtualMemory::get_page_size();
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = page_size * 16;
+	desc.thread_chunk_bytes = page_size;
+
+	PageAllocator pa;
+	pa.init(desc);
+
+	void*first = pa.allocate(32, 8);
+	void*second = pa.allocate(32, 8);
+	ASSERT_NE(second, nullptr);
+
+	pa.reset();
+
+	void*again = pa.allocate(32, 8);
+	EXPECT_EQ(again, first);
+}
+
+TEST(PageAllocatorTest, ThreadChunksDoNotOverlap){
+	std::size_t page_size = VirtualMemory::get_page_size();
+	constexpr std::size_t threads = 4;
+	constexpr std::size_t per_thread = 2000;
+	constexpr std::size_t block = 48;
+
+	PageAllocatorDesc desc;
+	desc.max_size_bytes = 64 * 1024 * 1024;
+	desc.thread_chunk_bytes = page_size * 2;
+
+	PageAllocator pa;
+	pa.init(desc);
+
+	std::vector<std::vector<std::byte*>> ptrs(threads);
+	std::vector<std::thread> workers;
+	for(std::size_t t = 0; t < threads; ++t){
+		workers.emplace_back([&, t]{
+			for(std::size_t i = 0; i < per_thread; ++i){
+				auto* p = static_cast<std::byte*>(pa.allocate(block, 16));
+				if(!p) return;
+				std::memset(p, static_cast<int>(t), block);
+				ptrs[t].push_back(p);
+			}
+		});
+	}
+	for(auto& w : workers) w.join();
+
+	std::vector<std::byte*> all;
+	for(std::size_t t = 0; t < threads; ++t){
+		ASSERT_EQ(ptrs[t].size(), per_thread);
+		for(auto* p : ptrs[t]){
+			EXPECT_EQ(p[block - 1], static_cast<std::byte>(t));
+			all.push_back(p);
+		}
+	}
+
+	std::sort(all.begin(), all.end());
+	for(std::size_t i = 1; i < all.size(); ++i){
+		ASSERT_GE(all[i] - all[i-1], static_cast<std::ptrdiff_t>(block));
+	}
+}
+
 struct GameEntity{
 	float x,y,z;
 	int id;
@@ -529,6 +2222,24 @@ TEST(VirutalMemoryTest, PartialCommit){
 	VirtualMemory::release(ptr, total_size);
 }
 
+TEST(VirutalMemoryTest, ReserveHugeIsAlignedAndCommittable){
+	const std::size_t huge = VirtualMemory::get_huge_page_size();
+	if(huge == 0) GTEST_SKIP() << "no huge page support";
+
+	PageBacking backing = PageBacking::ExplicitHuge;
+	void*ptr = VirtualMemory::reserve_huge(huge * 2, backing);
+	ASSERT_NE(ptr, nullptr);
+	if(backing != PageBacking::Regular){
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % huge, 0u);
+	}
+
+	ASSERT_TRUE(VirtualMemory::commit(ptr, huge));
+	static_cast<int*>(ptr)[0] = 42;
+	EXPECT_EQ(static_cast<int*>(ptr)[0], 42);
+
+	VirtualMemory::release(ptr, huge * 2);
+}
+
 TEST(VirutalMemoryTest, OSAlignedAllocRespectsAlignment){
 	std::size_t size = 1024;
 	std::size_t alignment = 256;
@@ -577,3 +2288,94 @@ TEST(VirtualMemoryTest, AccessingDecommitedMemory){
 		VirtualMemory::release(ptr,psize);
 	}, "");
 }
+
+namespace{
+
+std::string write_temp_file(const char* name, const std::vector<std::uint32_t>& values){
+	const auto path = std::filesystem::temp_directory_path() / name;
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(values.data()),
+		static_cast<std::streamsize>(values.size() * sizeof(std::uint32_t)));
+	return path.string();
+}
+
+} // namespace
+
+TEST(MappedFileTest, ReadsFileInPlace){
+	std::vector<std::uint32_t> values(100000);
+	for(std::uint32_t i = 0; i < values.size(); ++i) values[i] = i * 7;
+	const std::string path = write_temp_file("engine_mapped_ro.bin", values);
+
+	MappedFile file(path, MapMode::ReadOnly, AccessHint::Sequential);
+	ASSERT_TRUE(file.is_open());
+	EXPECT_EQ(file.size(), values.size() * sizeof(std::uint32_t));
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(file.data()) % VirtualMemory::get_page_size(), 0u);
+	EXPECT_EQ(file.mutable_data(), nullptr);
+
+	auto view = file.as<std::uint32_t>();
+	ASSERT_EQ(view.size(), values.size());
+	EXPECT_TRUE(std::equal(view.begin(), view.end(), values.begin()));
+
+	file.advise(AccessHint::Random);
+	file.advise(AccessHint::WillNeed);
+
+	MappedFile moved = std::move(file);
+	EXPECT_FALSE(file.is_open());
+	EXPECT_EQ(moved.as<std::uint32_t>()[99999], 99999u * 7);
+
+	moved.close();
+	EXPECT_FALSE(moved.is_open());
+	std::filesystem::remove(path);
+}
+
+TEST(MappedFileTest, CopyOnWriteLeavesFileUntouched){
+	const std::vector<std::uint32_t> values(4096, 0xABCDu);
+	const std::string path = write_temp_file("engine_mapped_cow.bin", values);
+
+	{
+		MappedFile file(path, MapMode::CopyOnWrite);
+		ASSERT_TRUE(file.is_open());
+		ASSERT_NE(file.mutable_data(), nullptr);
+		std::memset(file.mutable_data(), 0, file.size());
+		EXPECT_EQ(file.as<std::uint32_t>()[0], 0u);
+	}
+
+	MappedFile again(path);
+	ASSERT_TRUE(again.is_open());
+	EXPECT_EQ(again.as<std::uint32_t>()[0], 0xABCDu);
+	EXPECT_EQ(again.as<std::uint32_t>()[4095], 0xABCDu);
+	again.close();
+	std::filesystem::remove(path);
+}
+
+TEST(MappedFileTest, MissingOrEmptyFilesStayClosed){
+	MappedFile missing("/definitely/not/here.bin");
+	EXPECT_FALSE(missing.is_open());
+	EXPECT_EQ(missing.size(), 0u);
+
+	const std::string path = write_temp_file("engine_mapped_empty.bin", {});
+	MappedFile empty;
+	EXPECT_FALSE(empty.open(path));
+	EXPECT_TRUE(empty.bytes().empty());
+	std::filesystem::remove(path);
+}
+
+TEST(FiberStackTest, GuardPageBelowStack){
+	const std::size_t page_size = VirtualMemory::get_page_size();
+	FiberStack stack(page_size * 16 + 1);
+	EXPECT_EQ(stack.size(), page_size * 17);
+	EXPECT_EQ(stack.guard_bytes(), page_size);
+	EXPECT_EQ(static_cast<std::byte*>(stack.top()) - static_cast<std::byte*>(stack.base()),
+		static_cast<std::ptrdiff_t>(stack.size()));
+
+	auto* base = static_cast<std::byte*>(stack.base());
+	std::memset(base, 0xCC, stack.size());
+
+	FiberStack moved = std::move(stack);
+	EXPECT_EQ(stack.base(), nullptr);
+	EXPECT_EQ(moved.base(), base);
+
+	// running off the low end hits the guard
+	EXPECT_DEATH({ base[-1] = std::byte{1}; }, "");
+	EXPECT_DEATH({ base[-static_cast<std::ptrdiff_t>(page_size)] = std::byte{1}; }, "");
+}